@@ -0,0 +1,332 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BitPlanes.h"
+#include "CounterRandom.h"
+#include "Ensemble.h"
+#include "EntityKernels.h"
+#include "EntityType.h"
+#include "Ocean.h"
+
+// Все прогоны используют фиксированные зёрна, чтобы результаты разных
+// коммитов можно было сравнивать между собой.
+
+namespace {
+
+constexpr std::uint64_t SEED = 12345;
+
+// Доли заполнения в процентах: 0 — разреженный мир, 1 — как в окне, 2 — плотный.
+void fillOcean(Ocean& ocean, int density) {
+    long long cells = static_cast<long long>(ocean.getWidth()) * ocean.getHeight();
+    switch (density) {
+        case 0:
+            ocean.randomFill(static_cast<int>(cells / 100), static_cast<int>(cells / 500),
+                             static_cast<int>(cells / 1500));
+            break;
+        case 1:
+            ocean.randomFill(static_cast<int>(cells / 10), static_cast<int>(cells / 50),
+                             static_cast<int>(cells / 150));
+            break;
+        default:
+            ocean.randomFill(static_cast<int>(cells * 3 / 10), static_cast<int>(cells / 10),
+                             static_cast<int>(cells / 30));
+            break;
+    }
+}
+
+void setRates(benchmark::State& state, double cellsPerIteration) {
+    state.counters["ticks/s"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                   benchmark::Counter::kIsRate);
+    state.counters["cells/s"] = benchmark::Counter(cellsPerIteration * state.iterations(),
+                                                   benchmark::Counter::kIsRate);
+}
+
+void BM_OceanTick(benchmark::State& state) {
+    int width = static_cast<int>(state.range(0));
+    int height = static_cast<int>(state.range(1));
+    Ocean ocean(width, height, SEED);
+    fillOcean(ocean, static_cast<int>(state.range(2)));
+    for (auto _ : state) {
+        ocean.tick();
+    }
+    setRates(state, static_cast<double>(width) * height);
+}
+BENCHMARK(BM_OceanTick)
+    ->ArgNames({"w", "h", "density"})
+    ->Args({80, 40, 1})
+    ->Args({256, 256, 0})->Args({256, 256, 1})->Args({256, 256, 2})
+    ->Args({1024, 1024, 0})->Args({1024, 1024, 1})->Args({1024, 1024, 2})
+    ->Args({4096, 4096, 0})->Args({4096, 4096, 1})
+    ->Args({8192, 8192, 0})->Args({8192, 8192, 1})
+    ->Unit(benchmark::kMillisecond);
+
+// Раскладка памяти: 0 — построчно, 1 — блоками, 2 — блоками в Z-порядке.
+// 1024x1024 помещается в последний уровень кэша, 8192x8192 (около 700 МБ на
+// оба буфера) — нет; на нём и видна разница в промахах TLB.
+void BM_OceanTickLayout(benchmark::State& state) {
+    int size = static_cast<int>(state.range(0));
+    Ocean ocean(size, size, SEED, Boundary::Walls, static_cast<GridLayout>(state.range(1)));
+    fillOcean(ocean, 1);
+    // Первый такт размечает заявки и поднимает страницы — не в замер.
+    ocean.tick();
+    for (auto _ : state) {
+        ocean.tick();
+    }
+    setRates(state, static_cast<double>(size) * size);
+}
+BENCHMARK(BM_OceanTickLayout)
+    ->ArgNames({"size", "layout"})
+    ->ArgsProduct({{1024, 8192}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_OceanTickThreads(benchmark::State& state) {
+    Ocean ocean(2048, 2048, SEED);
+    ocean.setThreadCount(static_cast<int>(state.range(0)));
+    fillOcean(ocean, 1);
+    for (auto _ : state) {
+        ocean.tick();
+    }
+    setRates(state, 2048.0 * 2048.0);
+}
+BENCHMARK(BM_OceanTickThreads)
+    ->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Минимальная сетка с рамкой для запуска одного ядра без Ocean.
+class BenchGrid {
+public:
+    BenchGrid(int width, int height)
+        : width(width), height(height), stride(static_cast<std::size_t>(width) + 2),
+          cells(stride * (static_cast<std::size_t>(height) + 2), BORDER_CELL),
+          age(cells.size(), 0), hunger(cells.size(), 0) {
+        for (int y = 0; y < height; ++y) {
+            std::fill_n(cells.begin() + index(0, y), width, EntityType::Sand);
+        }
+    }
+
+    std::size_t index(int x, int y) const {
+        return static_cast<std::size_t>(y + 1) * stride + static_cast<std::size_t>(x + 1);
+    }
+    EntityType cellAt(int x, int y) const { return cells[index(x, y)]; }
+    int ageAt(int x, int y) const { return age[index(x, y)]; }
+    int hungerAt(int x, int y) const { return hunger[index(x, y)]; }
+    void put(int x, int y, EntityType type, int age = 0, int hunger = 0) {
+        std::size_t i = index(x, y);
+        cells[i] = type;
+        this->age[i] = static_cast<std::uint16_t>(age);
+        this->hunger[i] = static_cast<std::uint16_t>(hunger);
+    }
+
+    int width;
+    int height;
+    std::size_t stride;
+    std::vector<EntityType> cells;
+    std::vector<std::uint16_t> age;
+    std::vector<std::uint16_t> hunger;
+};
+
+// Состояние, в котором у каждого существа есть и добыча, и свободные клетки,
+// а возраст позволяет размножаться.
+BenchGrid makeKernelGrid(int size) {
+    BenchGrid grid(size, size);
+    CounterRandom gen(SEED, 0);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            std::uint32_t roll = gen.below(100);
+            if (roll < 30) grid.put(x, y, EntityType::Algae, 6, 0);
+            else if (roll < 40) grid.put(x, y, EntityType::HerbivoreFish, 12, 3);
+            else if (roll < 45) grid.put(x, y, EntityType::PredatorFish, 16, 3);
+        }
+    }
+    return grid;
+}
+
+// runtime:0 — параметры по умолчанию как константы, runtime:1 — те же
+// значения из SpeciesParams, как при загрузке из файла.
+template <EntityType Type>
+void BM_Kernel(benchmark::State& state) {
+    const bool runtime = state.range(0) != 0;
+    const SpeciesParams params = defaultSpeciesParams<Type>();
+    const int size = 512;
+    const BenchGrid current = makeKernelGrid(size);
+
+    std::vector<std::pair<int, int>> creatures;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            if (current.cellAt(x, y) == Type) {
+                creatures.emplace_back(x, y);
+            }
+        }
+    }
+
+    // Ядро только читает поле и возвращает намерение; разбор заявок — в BM_OceanTick.
+    std::uint64_t round = 0;
+    for (auto _ : state) {
+        std::uint64_t key = CounterRandom::key(SEED, round++);
+        for (const auto& [x, y] : creatures) {
+            CounterRandom gen(key, static_cast<std::uint64_t>(y) * size + x);
+            Intent intent = runtime ? EntityKernel<Type>::propose(x, y, current, gen, params)
+                                    : EntityKernel<Type>::propose(x, y, current, gen);
+            benchmark::DoNotOptimize(intent);
+        }
+    }
+    state.counters["creatures/s"] = benchmark::Counter(
+        static_cast<double>(creatures.size()) * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_Kernel, EntityType::Algae)->Name("BM_AlgaeKernel")
+    ->ArgName("runtime")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Kernel, EntityType::HerbivoreFish)->Name("BM_HerbivoreKernel")
+    ->ArgName("runtime")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Kernel, EntityType::PredatorFish)->Name("BM_PredatorKernel")
+    ->ArgName("runtime")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+void BM_RandomFill(benchmark::State& state) {
+    const int size = 1024;
+    long long cells = static_cast<long long>(size) * size;
+    long long filled = cells * state.range(0) / 100;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Ocean ocean(size, size, SEED);
+        state.ResumeTiming();
+        ocean.randomFill(static_cast<int>(filled * 6 / 10), static_cast<int>(filled * 3 / 10),
+                         static_cast<int>(filled - filled * 6 / 10 - filled * 3 / 10));
+        benchmark::DoNotOptimize(ocean);
+    }
+    state.counters["cells/s"] = benchmark::Counter(static_cast<double>(cells) * state.iterations(),
+                                                   benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RandomFill)
+    ->ArgName("fill%")->Arg(10)->Arg(50)->Arg(90)->Arg(99)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CountEntities(benchmark::State& state) {
+    int size = static_cast<int>(state.range(0));
+    Ocean ocean(size, size, SEED);
+    fillOcean(ocean, 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ocean.countEntities(EntityType::Algae));
+        benchmark::DoNotOptimize(ocean.countEntities(EntityType::HerbivoreFish));
+        benchmark::DoNotOptimize(ocean.countEntities(EntityType::PredatorFish));
+    }
+    state.counters["cells/s"] = benchmark::Counter(3.0 * size * size * state.iterations(),
+                                                   benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CountEntities)
+    ->ArgName("size")->Arg(80)->Arg(1024)->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SummedAreaBuild(benchmark::State& state) {
+    int size = static_cast<int>(state.range(0));
+    Ocean ocean(size, size, SEED);
+    fillOcean(ocean, 1);
+    for (auto _ : state) {
+        // Любая правка поля делает таблицу устаревшей.
+        ocean.setCell(0, 0, ocean.getCellType(0, 0));
+        benchmark::DoNotOptimize(&ocean.getSummedArea());
+    }
+    setRates(state, static_cast<double>(size) * size);
+}
+BENCHMARK(BM_SummedAreaBuild)
+    ->ArgName("size")->Arg(1024)->Arg(4096)
+    ->Unit(benchmark::kMillisecond);
+
+// Окна 64x64 по всему полю: таблицей сумм (table:1) против обхода клеток (table:0).
+void BM_WindowCounts(benchmark::State& state) {
+    const int size = 1024;
+    const int window = 64;
+    bool table = state.range(0) != 0;
+    Ocean ocean(size, size, SEED);
+    fillOcean(ocean, 1);
+    ocean.getSummedArea();
+    for (auto _ : state) {
+        long long total = 0;
+        for (int y = 0; y + window <= size; y += window / 2) {
+            for (int x = 0; x + window <= size; x += window / 2) {
+                if (table) {
+                    total += ocean.countInRect(EntityType::PredatorFish, x, y, window, window);
+                    continue;
+                }
+                for (int j = y; j < y + window; ++j) {
+                    for (int i = x; i < x + window; ++i) {
+                        total += ocean.getCellType(i, j) == EntityType::PredatorFish;
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+BENCHMARK(BM_WindowCounts)
+    ->ArgName("table")->Arg(0)->Arg(1)
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_PackPlanes(benchmark::State& state) {
+    int size = static_cast<int>(state.range(0));
+    Ocean ocean(size, size, SEED);
+    fillOcean(ocean, 1);
+    BitPlanes planes;
+    for (auto _ : state) {
+        ocean.packPlanes(planes);
+        benchmark::DoNotOptimize(planes.row(EntityType::Algae, 0));
+    }
+    setRates(state, static_cast<double>(size) * size);
+}
+BENCHMARK(BM_PackPlanes)
+    ->ArgName("size")->Arg(1024)->Arg(4096)
+    ->Unit(benchmark::kMicrosecond);
+
+// Подсчёт соседей-водорослей для всех клеток: 0 — скаляр, 1 — SSE2, 2 — AVX2.
+void BM_NeighbourCounts(benchmark::State& state) {
+    int size = static_cast<int>(state.range(0));
+    SimdLevel level = static_cast<SimdLevel>(state.range(1));
+    if (level > bestSimdLevel()) {
+        state.SkipWithError("instruction set not supported on this machine");
+        return;
+    }
+    Ocean ocean(size, size, SEED);
+    fillOcean(ocean, 1);
+    BitPlanes planes;
+    ocean.packPlanes(planes);
+    NeighbourCounts counts;
+    for (auto _ : state) {
+        countNeighbours(planes, EntityType::Algae, counts, level);
+        benchmark::DoNotOptimize(counts.bits[0].data());
+    }
+    state.SetLabel(simdLevelName(level));
+    setRates(state, static_cast<double>(size) * size);
+}
+BENCHMARK(BM_NeighbourCounts)
+    ->ArgNames({"size", "simd"})
+    ->ArgsProduct({{1024, 4096}, {0, 1, 2}})
+    ->Unit(benchmark::kMicrosecond);
+
+
+// Ансамбль из 64 полей 80x40: сколько тактов-океанов в секунду при разной пачке.
+void BM_Ensemble(benchmark::State& state) {
+    const int members = 64;
+    const long long ticks = 64;
+    std::vector<EnsembleMember> configs(members);
+    for (int i = 0; i < members; ++i) {
+        configs[i].seed = SEED + static_cast<std::uint64_t>(i);
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        Ensemble ensemble(configs);
+        state.ResumeTiming();
+        ensemble.run(ticks, static_cast<int>(state.range(1)), static_cast<int>(state.range(0)), nullptr);
+    }
+    state.counters["ocean_ticks/s"] = benchmark::Counter(static_cast<double>(members) * ticks * state.iterations(),
+                                                         benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Ensemble)
+    ->ArgNames({"batch", "threads"})
+    ->ArgsProduct({{1, 8, 64}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}
+
+BENCHMARK_MAIN();
@@ -3,16 +3,14 @@
 
 #include "Entity.h"
 #include "EntityType.h"
+#include "SpeciesParams.h"
 #include <memory>
-#include <vector>
-#include <utility>
-#include <random>
 
 class Algae : public Entity {
-    int age = 0;
-    static constexpr int MAX_AGE = 20;
-    static constexpr int REPRODUCE_AGE = 5;
 public:
+    static constexpr int MAX_AGE = DefaultSpeciesParams<EntityType::Algae>::maxAge;
+    static constexpr int REPRODUCE_AGE = DefaultSpeciesParams<EntityType::Algae>::reproduceAge;
+
     EntityType getType() const override;
     std::unique_ptr<Entity> clone() const override;
     void tick(int x, int y, IOcean& current, IWritableOcean& next) override;
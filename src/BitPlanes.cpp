@@ -0,0 +1,218 @@
+#include "BitPlanes.h"
+#include "BitSlice.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef OCEAN_HAVE_AVX2
+// Определена в BitPlanesAvx2.cpp, который собирается с -mavx2.
+void countRowAvx2(const std::uint64_t* up, const std::uint64_t* mid, const std::uint64_t* down,
+                  std::uint64_t* const out[4], std::size_t words);
+#endif
+
+BitPlanes::BitPlanes(int width, int height) {
+    resize(width, height);
+}
+
+void BitPlanes::resize(int width, int height) {
+    if (width < 0 || height < 0) {
+        throw std::invalid_argument("BitPlanes: Width and height must not be negative.");
+    }
+    this->width = width;
+    this->height = height;
+    words = (static_cast<std::size_t>(width) + 63) / 64;
+    stride = words + 2;
+    for (std::vector<std::uint64_t>& plane : planes) {
+        plane.assign(stride * (static_cast<std::size_t>(height) + 2), 0);
+    }
+}
+
+void BitPlanes::clear() {
+    for (std::vector<std::uint64_t>& plane : planes) {
+        std::fill(plane.begin(), plane.end(), 0);
+    }
+}
+
+void BitPlanes::packRow(int y, const EntityType* cells) {
+    if (y < 0 || y >= height) {
+        throw std::out_of_range("BitPlanes::packRow: Row out of bounds");
+    }
+    std::uint64_t* out[4];
+    for (int type = 0; type < 4; ++type) {
+        out[type] = row(static_cast<EntityType>(type), y);
+    }
+    for (std::size_t w = 0; w < words; ++w) {
+        std::size_t begin = w * 64;
+        std::size_t count = std::min<std::size_t>(64, static_cast<std::size_t>(width) - begin);
+        const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(cells + begin);
+        std::uint64_t bits[4] = {0, 0, 0, 0};
+        std::size_t x = 0;
+#ifdef __SSE2__
+        // Сравнение 16 байт разом, movemask сразу даёт 16 бит плоскости.
+        for (; x + 16 <= count; x += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + x));
+            for (int type = 0; type < 4; ++type) {
+                __m128i match = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(static_cast<char>(type)));
+                bits[type] |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(match))) << x;
+            }
+        }
+#endif
+        for (; x < count; ++x) {
+            if (bytes[x] < 4) {
+                bits[bytes[x]] |= std::uint64_t{1} << x;
+            }
+        }
+        for (int type = 0; type < 4; ++type) {
+            out[type][w] = bits[type];
+        }
+    }
+}
+
+void BitPlanes::set(int x, int y, EntityType type) {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        throw std::out_of_range("BitPlanes::set: Coordinates out of bounds");
+    }
+    std::uint64_t bit = std::uint64_t{1} << (x % 64);
+    for (int other = 0; other < 4; ++other) {
+        row(static_cast<EntityType>(other), y)[x / 64] &= ~bit;
+    }
+    if (static_cast<std::size_t>(type) < planes.size()) {
+        row(type, y)[x / 64] |= bit;
+    }
+}
+
+bool BitPlanes::test(EntityType type, int x, int y) const {
+    if (static_cast<std::size_t>(type) >= planes.size() || x < 0 || x >= width || y < 0 || y >= height) {
+        return false;
+    }
+    return (row(type, y)[x / 64] >> (x % 64)) & 1;
+}
+
+unsigned BitPlanes::neighbourMask(EntityType type, int x, int y) const {
+    // Порядок битов тот же, что у NEIGHBOUR_DX/NEIGHBOUR_DY в EntityKernels.h.
+    static constexpr int DX[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    static constexpr int DY[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+    unsigned mask = 0;
+    for (int k = 0; k < 8; ++k) {
+        mask |= static_cast<unsigned>(test(type, x + DX[k], y + DY[k])) << k;
+    }
+    return mask;
+}
+
+int NeighbourCounts::at(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        throw std::out_of_range("NeighbourCounts::at: Coordinates out of bounds");
+    }
+    std::size_t i = static_cast<std::size_t>(y) * words + static_cast<std::size_t>(x / 64);
+    int shift = x % 64;
+    int count = 0;
+    for (int k = 0; k < 4; ++k) {
+        count |= static_cast<int>((bits[k][i] >> shift) & 1) << k;
+    }
+    return count;
+}
+
+void NeighbourCounts::toBytes(std::vector<std::uint8_t>& out) const {
+    out.resize(static_cast<std::size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        std::uint8_t* row = out.data() + static_cast<std::size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            std::size_t i = static_cast<std::size_t>(y) * words + static_cast<std::size_t>(x / 64);
+            int shift = x % 64;
+            row[x] = static_cast<std::uint8_t>(((bits[0][i] >> shift) & 1) | ((bits[1][i] >> shift) & 1) << 1 |
+                                               ((bits[2][i] >> shift) & 1) << 2 | ((bits[3][i] >> shift) & 1) << 3);
+        }
+    }
+}
+
+SimdLevel bestSimdLevel() {
+#if defined(OCEAN_HAVE_AVX2)
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2) {
+        return SimdLevel::Avx2;
+    }
+#endif
+#ifdef __SSE2__
+    return SimdLevel::Sse2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Sse2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+#ifdef __SSE2__
+// Два слова за раз; сдвиги _mm_slli_epi64 работают внутри 64-битных половин,
+// а переносы берутся из тех же данных, загруженных со смещением на слово.
+static void countRowSse2(const std::uint64_t* up, const std::uint64_t* mid, const std::uint64_t* down,
+                         std::uint64_t* const out[4], std::size_t words) {
+    auto load = [](const std::uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+    auto west = [&](const std::uint64_t* row, std::size_t i) {
+        return _mm_or_si128(_mm_slli_epi64(load(row + i), 1), _mm_srli_epi64(load(row + i - 1), 63));
+    };
+    auto east = [&](const std::uint64_t* row, std::size_t i) {
+        return _mm_or_si128(_mm_srli_epi64(load(row + i), 1), _mm_slli_epi64(load(row + i + 1), 63));
+    };
+    std::size_t i = 0;
+    for (; i + 2 <= words; i += 2) {
+        __m128i sum[4];
+        sumEight(west(up, i), load(up + i), east(up, i), west(mid, i), east(mid, i),
+                 west(down, i), load(down + i), east(down, i), sum);
+        for (int k = 0; k < 4; ++k) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out[k] + i), sum[k]);
+        }
+    }
+    countWordsScalar(up, mid, down, out, i, words);
+}
+#endif
+
+void countNeighbours(const BitPlanes& planes, EntityType type, NeighbourCounts& out) {
+    countNeighbours(planes, type, out, bestSimdLevel());
+}
+
+void countNeighbours(const BitPlanes& planes, EntityType type, NeighbourCounts& out, SimdLevel level) {
+    if (static_cast<std::size_t>(type) >= 4) {
+        throw std::invalid_argument("countNeighbours: Unknown entity type.");
+    }
+    level = std::min(level, bestSimdLevel());
+    out.width = planes.getWidth();
+    out.height = planes.getHeight();
+    out.words = planes.getWordsPerRow();
+    for (std::vector<std::uint64_t>& bits : out.bits) {
+        bits.resize(out.words * static_cast<std::size_t>(out.height));
+    }
+
+    for (int y = 0; y < out.height; ++y) {
+        const std::uint64_t* up = planes.row(type, y - 1);
+        const std::uint64_t* mid = planes.row(type, y);
+        const std::uint64_t* down = planes.row(type, y + 1);
+        std::size_t offset = static_cast<std::size_t>(y) * out.words;
+        std::uint64_t* const rowOut[4] = {out.bits[0].data() + offset, out.bits[1].data() + offset,
+                                          out.bits[2].data() + offset, out.bits[3].data() + offset};
+        switch (level) {
+#ifdef OCEAN_HAVE_AVX2
+            case SimdLevel::Avx2:
+                countRowAvx2(up, mid, down, rowOut, out.words);
+                break;
+#endif
+#ifdef __SSE2__
+            case SimdLevel::Sse2:
+                countRowSse2(up, mid, down, rowOut, out.words);
+                break;
+#endif
+            default:
+                countWordsScalar(up, mid, down, rowOut, 0, out.words);
+                break;
+        }
+    }
+}
\ No newline at end of file
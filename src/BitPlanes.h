@@ -0,0 +1,79 @@
+#ifndef BIT_PLANES_H
+#define BIT_PLANES_H
+
+#include "EntityType.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Поле, упакованное по битовым плоскостям: для каждого вида по одному биту
+// на клетку, 64 клетки в слове. Клетка (x, y) — бит x % 64 слова x / 64 строки y.
+// Вокруг каждой плоскости нулевая рамка в одно слово и одну строку, поэтому
+// соседей можно читать без проверки границ; за краем поля нет ни одного вида.
+// Плоскости служат для анализа поля и бенчмарков, такт их не использует: он
+// обходит только плитки с существами и читает байтовую сетку, а упаковка
+// всего поля на каждом такте свела бы эту экономию на нет.
+class BitPlanes {
+public:
+    BitPlanes(int width = 0, int height = 0);
+
+    void resize(int width, int height);
+    void clear();
+
+    // Упаковывает строку y из width значений EntityType.
+    void packRow(int y, const EntityType* cells);
+    void set(int x, int y, EntityType type);
+    bool test(EntityType type, int x, int y) const;
+
+    // Маска соседей вида type в порядке NEIGHBOUR_DX/NEIGHBOUR_DY.
+    unsigned neighbourMask(EntityType type, int x, int y) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    std::size_t getWordsPerRow() const { return words; }
+    std::size_t getStride() const { return stride; }
+
+    // Слова строки y (y от -1 до height включительно попадают в рамку).
+    const std::uint64_t* row(EntityType type, int y) const {
+        return planes[static_cast<std::size_t>(type)].data() + static_cast<std::size_t>(y + 1) * stride + 1;
+    }
+    std::uint64_t* row(EntityType type, int y) {
+        return planes[static_cast<std::size_t>(type)].data() + static_cast<std::size_t>(y + 1) * stride + 1;
+    }
+
+private:
+    int width = 0;
+    int height = 0;
+    std::size_t words = 0;
+    std::size_t stride = 0;
+    std::array<std::vector<std::uint64_t>, 4> planes;
+};
+
+// Число соседей (0..8) для каждой клетки в побитово-срезанном виде:
+// bits[k] хранит k-й разряд счётчика в той же раскладке, что и BitPlanes.
+struct NeighbourCounts {
+    int width = 0;
+    int height = 0;
+    std::size_t words = 0;
+    std::array<std::vector<std::uint64_t>, 4> bits;
+
+    int at(int x, int y) const;
+    // Клетки, у которых есть хотя бы один такой сосед.
+    bool any(int x, int y) const { return at(x, y) != 0; }
+    // Разворачивает счётчики в байт на клетку, построчно.
+    void toBytes(std::vector<std::uint8_t>& out) const;
+};
+
+enum class SimdLevel { Scalar, Sse2, Avx2 };
+
+// Лучший набор инструкций, доступный на этой машине.
+SimdLevel bestSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// Считает соседей вида type для всех клеток сразу. Уровень выше доступного
+// понижается до доступного, так что результат от него не зависит.
+void countNeighbours(const BitPlanes& planes, EntityType type, NeighbourCounts& out);
+void countNeighbours(const BitPlanes& planes, EntityType type, NeighbourCounts& out, SimdLevel level);
+
+#endif
\ No newline at end of file
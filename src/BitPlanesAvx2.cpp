@@ -0,0 +1,25 @@
+#include "BitSlice.h"
+
+#include <immintrin.h>
+
+// Этот файл собирается с -mavx2 и вызывается только после проверки процессора.
+void countRowAvx2(const std::uint64_t* up, const std::uint64_t* mid, const std::uint64_t* down,
+                  std::uint64_t* const out[4], std::size_t words) {
+    auto load = [](const std::uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); };
+    auto west = [&](const std::uint64_t* row, std::size_t i) {
+        return _mm256_or_si256(_mm256_slli_epi64(load(row + i), 1), _mm256_srli_epi64(load(row + i - 1), 63));
+    };
+    auto east = [&](const std::uint64_t* row, std::size_t i) {
+        return _mm256_or_si256(_mm256_srli_epi64(load(row + i), 1), _mm256_slli_epi64(load(row + i + 1), 63));
+    };
+    std::size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        __m256i sum[4];
+        sumEight(west(up, i), load(up + i), east(up, i), west(mid, i), east(mid, i),
+                 west(down, i), load(down + i), east(down, i), sum);
+        for (int k = 0; k < 4; ++k) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out[k] + i), sum[k]);
+        }
+    }
+    countWordsScalar(up, mid, down, out, i, words);
+}
\ No newline at end of file
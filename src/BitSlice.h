@@ -0,0 +1,47 @@
+#ifndef BIT_SLICE_H
+#define BIT_SLICE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Побитово-срезанный сумматор восьми однобитных входов. Word — std::uint64_t
+// или векторный тип с операторами &, |, ^ (расширение GCC/Clang для __m128i/__m256i),
+// поэтому одна и та же схема считает 64, 128 или 256 клеток за раз.
+// Функции static: файл с -mavx2 не должен подменить их копии в остальной сборке.
+template <class Word>
+static inline void sumEight(Word a, Word b, Word c, Word d, Word e, Word f, Word g, Word h, Word out[4]) {
+    Word s1 = a ^ b ^ c, c1 = (a & b) | (c & (a ^ b));
+    Word s2 = d ^ e ^ f, c2 = (d & e) | (f & (d ^ e));
+    Word s3 = g ^ h, c3 = g & h;
+    out[0] = s1 ^ s2 ^ s3;
+    Word c4 = (s1 & s2) | (s3 & (s1 ^ s2));
+    Word t1 = c1 ^ c2 ^ c3, d1 = (c1 & c2) | (c3 & (c1 ^ c2));
+    out[1] = t1 ^ c4;
+    Word d2 = t1 & c4;
+    out[2] = d1 ^ d2;
+    out[3] = d1 & d2;
+}
+
+// Соседи одного слова: сдвиг с переносом бита из соседнего слова.
+static inline std::uint64_t westOf(const std::uint64_t* row, std::size_t i) {
+    return (row[i] << 1) | (row[i - 1] >> 63);
+}
+
+static inline std::uint64_t eastOf(const std::uint64_t* row, std::size_t i) {
+    return (row[i] >> 1) | (row[i + 1] << 63);
+}
+
+// Скалярный счёт слов [begin, end) одной строки; up/mid/down — строки y-1, y, y+1.
+static inline void countWordsScalar(const std::uint64_t* up, const std::uint64_t* mid, const std::uint64_t* down,
+                                    std::uint64_t* const out[4], std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+        std::uint64_t sum[4];
+        sumEight(westOf(up, i), up[i], eastOf(up, i), westOf(mid, i), eastOf(mid, i),
+                 westOf(down, i), down[i], eastOf(down, i), sum);
+        for (int k = 0; k < 4; ++k) {
+            out[k][i] = sum[k];
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef BOUNDARY_H
+#define BOUNDARY_H
+
+#include "EntityType.h"
+#include "TickStats.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Что находится за краем поля: стена (соседей там нет), тор (край склеен
+// с противоположным) или отражение (за краем — зеркальная копия клеток у края,
+// сама крайняя клетка не повторяется).
+enum class Boundary : std::uint8_t { Walls, Torus, Reflect };
+
+// Разбор имени из командной строки: walls, torus или reflect.
+inline Boundary parseBoundary(const std::string& name) {
+    if (name == "walls") return Boundary::Walls;
+    if (name == "torus") return Boundary::Torus;
+    if (name == "reflect") return Boundary::Reflect;
+    throw std::invalid_argument("unknown boundary " + name + " (expected walls, torus or reflect)");
+}
+
+// Политики переводят координату, вышедшую за край не дальше чем на 2 клетки,
+// обратно в поле размера size (size >= 3).
+struct TorusBoundary {
+    static int map(int v, int size) { return v < 0 ? v + size : v >= size ? v - size : v; }
+};
+
+struct ReflectBoundary {
+    static int map(int v, int size) { return v < 0 ? -v : v >= size ? 2 * size - 2 - v : v; }
+};
+
+// Сетка для EntityKernel, которая заворачивает координаты по политике и
+// передаёт обращения дальше. Ocean использует её только в плитках у края,
+// внутренние плитки обращаются к буферу напрямую.
+template <class Grid, class Policy>
+class BoundaryGrid {
+public:
+    BoundaryGrid(Grid& grid, int width, int height) : grid(grid), width(width), height(height) {}
+
+    EntityType cellAt(int x, int y) const { return grid.cellAt(Policy::map(x, width), Policy::map(y, height)); }
+    int ageAt(int x, int y) const { return grid.ageAt(Policy::map(x, width), Policy::map(y, height)); }
+    int hungerAt(int x, int y) const { return grid.hungerAt(Policy::map(x, width), Policy::map(y, height)); }
+    void put(int x, int y, EntityType type, int age = 0, int hunger = 0) {
+        grid.put(Policy::map(x, width), Policy::map(y, height), type, age, hunger);
+    }
+    void noteEvent(TickEvent event, EntityType species) { ::noteEvent(grid, event, species); }
+
+private:
+    Grid& grid;
+    int width;
+    int height;
+};
+
+#endif
\ No newline at end of file
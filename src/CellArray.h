@@ -0,0 +1,58 @@
+#ifndef CELL_ARRAY_H
+#define CELL_ARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Массив ячеек буфера. Обычно владеет своей памятью, но может смотреть в
+// отображённый файл снимка (копия при записи): тогда страницы подгружаются
+// по первому обращению, а mapping держит отображение, пока массив жив.
+// Копия массива всегда владеет своей памятью.
+template <class T>
+class CellArray {
+public:
+    CellArray() = default;
+    CellArray(std::size_t size, T value) : owned(size, value), pointer(owned.data()), count(size) {}
+
+    CellArray(const CellArray& other) : owned(other.begin(), other.end()), pointer(owned.data()), count(other.count) {}
+    CellArray(CellArray&& other) noexcept { swap(other); }
+    CellArray& operator=(CellArray other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    static CellArray adopt(std::shared_ptr<void> mapping, T* data, std::size_t size) {
+        CellArray result;
+        result.mapping = std::move(mapping);
+        result.pointer = data;
+        result.count = size;
+        return result;
+    }
+
+    void swap(CellArray& other) noexcept {
+        owned.swap(other.owned);
+        mapping.swap(other.mapping);
+        std::swap(pointer, other.pointer);
+        std::swap(count, other.count);
+    }
+
+    T* data() { return pointer; }
+    const T* data() const { return pointer; }
+    std::size_t size() const { return count; }
+    T* begin() { return pointer; }
+    T* end() { return pointer + count; }
+    const T* begin() const { return pointer; }
+    const T* end() const { return pointer + count; }
+    T& operator[](std::size_t i) { return pointer[i]; }
+    const T& operator[](std::size_t i) const { return pointer[i]; }
+
+private:
+    std::vector<T> owned;
+    std::shared_ptr<void> mapping;
+    T* pointer = nullptr;
+    std::size_t count = 0;
+};
+
+#endif
\ No newline at end of file
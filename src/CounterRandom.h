@@ -0,0 +1,54 @@
+#ifndef COUNTER_RANDOM_H
+#define COUNTER_RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+// Счётный генератор на основе splitmix64. Последовательность определяется
+// только парой (key, stream): Ocean берёт key из (seed, номер такта), а stream —
+// номер ячейки, поэтому розыгрыш не зависит ни от порядка обхода, ни от потока.
+class CounterRandom {
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static constexpr std::uint64_t key(std::uint64_t seed, std::uint64_t tick) {
+        return mix(seed ^ mix(tick + GOLDEN));
+    }
+
+    CounterRandom(std::uint64_t key, std::uint64_t stream) : state(mix(key ^ mix(stream))) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        state += GOLDEN;
+        return mix(state);
+    }
+
+    // Равномерно в [0, bound), метод Лемира без смещения.
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t product = static_cast<std::uint32_t>((*this)()) * static_cast<std::uint64_t>(bound);
+        std::uint32_t low = static_cast<std::uint32_t>(product);
+        if (low < bound) {
+            std::uint32_t threshold = static_cast<std::uint32_t>(-bound) % bound;
+            while (low < threshold) {
+                product = static_cast<std::uint32_t>((*this)()) * static_cast<std::uint64_t>(bound);
+                low = static_cast<std::uint32_t>(product);
+            }
+        }
+        return static_cast<std::uint32_t>(product >> 32);
+    }
+
+private:
+    static constexpr std::uint64_t GOLDEN = 0x9E3779B97F4A7C15ULL;
+
+    std::uint64_t state;
+};
+
+#endif
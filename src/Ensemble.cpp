@@ -0,0 +1,126 @@
+#include "Ensemble.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+Ensemble::Ensemble(std::vector<EnsembleMember> members) : config(std::move(members)) {
+    if (config.empty()) {
+        throw std::invalid_argument("Ensemble: At least one member is required.");
+    }
+    oceans.reserve(config.size());
+    for (const EnsembleMember& member : config) {
+        if (member.algae < 0 || member.herbivores < 0 || member.predators < 0 ||
+            member.algae + member.herbivores + member.predators > 1) {
+            throw std::invalid_argument("Ensemble: Fill fractions must be non-negative and sum to at most 1.");
+        }
+        oceans.emplace_back(member.width, member.height, member.seed, member.boundary);
+        oceans.back().setSpeciesParams(member.params);
+        double cells = static_cast<double>(member.width) * member.height;
+        oceans.back().randomFill(static_cast<int>(cells * member.algae),
+                                 static_cast<int>(cells * member.herbivores),
+                                 static_cast<int>(cells * member.predators));
+    }
+    extinction.assign(config.size(), {-1, -1, -1, -1});
+}
+
+void Ensemble::run(long long ticks, int threadCount, int batchTicks,
+                   const std::function<void(const EnsembleRow&)>& onRow) {
+    if (ticks < 0 || threadCount <= 0 || batchTicks <= 0) {
+        throw std::invalid_argument("Ensemble::run: Tick count must be non-negative, threads and batch positive.");
+    }
+    std::unique_ptr<ThreadPool> pool = threadCount > 1 ? std::make_unique<ThreadPool>(threadCount) : nullptr;
+    std::size_t batch = static_cast<std::size_t>(batchTicks);
+    // Слот 0 — состояние перед пачкой, дальше по слоту на каждый такт пачки.
+    history.assign(oceans.size() * (batch + 1), EntityCounts{});
+    long long start = oceans.front().getTickCount();
+
+    for (std::size_t i = 0; i < oceans.size(); ++i) {
+        history[i * (batch + 1)] = oceans[i].countAllEntities();
+    }
+    emitRow(0, start, onRow);
+
+    for (long long done = 0; done < ticks;) {
+        std::size_t steps = static_cast<std::size_t>(std::min<long long>(batchTicks, ticks - done));
+        auto advance = [&](std::size_t i, int) {
+            EntityCounts* counts = history.data() + i * (batch + 1);
+            for (std::size_t step = 1; step <= steps; ++step) {
+                oceans[i].tick();
+                counts[step] = oceans[i].countAllEntities();
+            }
+        };
+        if (pool) {
+            pool->parallelFor(oceans.size(), advance);
+        } else {
+            for (std::size_t i = 0; i < oceans.size(); ++i) {
+                advance(i, 0);
+            }
+        }
+        for (std::size_t step = 1; step <= steps; ++step) {
+            emitRow(step, start + done + static_cast<long long>(step), onRow);
+        }
+        // Последний такт пачки становится исходным состоянием следующей.
+        for (std::size_t i = 0; i < oceans.size(); ++i) {
+            history[i * (batch + 1)] = history[i * (batch + 1) + steps];
+        }
+        done += static_cast<long long>(steps);
+    }
+}
+
+void Ensemble::emitRow(std::size_t slot, long long tick, const std::function<void(const EnsembleRow&)>& onRow) {
+    std::size_t stride = history.size() / oceans.size();
+    double n = static_cast<double>(oceans.size());
+    EnsembleRow row;
+    row.tick = tick;
+    for (std::size_t i = 0; i < oceans.size(); ++i) {
+        const EntityCounts& counts = history[i * stride + slot];
+        for (std::size_t type = 0; type < counts.size(); ++type) {
+            row.mean[type] += static_cast<double>(counts[type]);
+            if (counts[type] == 0 && extinction[i][type] < 0) {
+                extinction[i][type] = tick;
+            }
+            row.extinct[type] += extinction[i][type] >= 0;
+        }
+    }
+    for (double& mean : row.mean) {
+        mean /= n;
+    }
+    if (oceans.size() > 1) {
+        for (std::size_t i = 0; i < oceans.size(); ++i) {
+            const EntityCounts& counts = history[i * stride + slot];
+            for (std::size_t type = 0; type < counts.size(); ++type) {
+                double deviation = static_cast<double>(counts[type]) - row.mean[type];
+                row.variance[type] += deviation * deviation;
+            }
+        }
+        for (double& variance : row.variance) {
+            variance /= n - 1;
+        }
+    }
+    if (onRow) {
+        onRow(row);
+    }
+}
+
+long long Ensemble::extinctionTick(int member, EntityType species) const {
+    return extinction.at(member).at(static_cast<std::size_t>(species));
+}
+
+ExtinctionSummary Ensemble::extinctionSummary(EntityType species) const {
+    ExtinctionSummary summary;
+    double total = 0;
+    for (const auto& ticks : extinction) {
+        long long tick = ticks.at(static_cast<std::size_t>(species));
+        if (tick < 0) {
+            continue;
+        }
+        ++summary.extinct;
+        total += static_cast<double>(tick);
+        summary.firstTick = summary.firstTick < 0 ? tick : std::min(summary.firstTick, tick);
+        summary.lastTick = std::max(summary.lastTick, tick);
+    }
+    if (summary.extinct > 0) {
+        summary.meanTick = total / summary.extinct;
+    }
+    return summary;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "Ocean.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Один участник ансамбля: размер поля, зерно, доли клеток для randomFill и параметры видов.
+struct EnsembleMember {
+    int width = 80;
+    int height = 40;
+    std::uint64_t seed = 0;
+    double algae = 1.0 / 10;
+    double herbivores = 1.0 / 50;
+    double predators = 1.0 / 150;
+    Boundary boundary = Boundary::Walls;
+    EcosystemParams params;
+};
+
+// Сводка по всем участникам на одном такте; индекс массивов — EntityType.
+struct EnsembleRow {
+    long long tick = 0;
+    std::array<double, 4> mean{};
+    std::array<double, 4> variance{};   // несмещённая, по участникам
+    std::array<int, 4> extinct{};       // участников, где вид уже вымер
+};
+
+// Вымирание вида по всему ансамблю.
+struct ExtinctionSummary {
+    int extinct = 0;            // сколько участников потеряли вид
+    double meanTick = 0;        // средний такт вымирания среди них
+    long long firstTick = -1;
+    long long lastTick = -1;
+};
+
+// Много независимых небольших океанов, которые считаются параллельно.
+// Каждый участник — отдельная задача пула; за один захват участник проходит
+// пачку тактов, чтобы расходы на раздачу работы не зависели от числа тактов.
+// Участники не влияют друг на друга, поэтому результат не зависит от числа потоков.
+class Ensemble {
+public:
+    explicit Ensemble(std::vector<EnsembleMember> members);
+
+    int size() const { return static_cast<int>(oceans.size()); }
+    const EnsembleMember& memberConfig(int member) const { return config.at(member); }
+    const Ocean& member(int member) const { return oceans.at(member); }
+
+    // Продвигает всех участников на ticks тактов. onRow получает сводку по
+    // каждому такту по порядку, начиная с текущего состояния.
+    void run(long long ticks, int threadCount, int batchTicks,
+             const std::function<void(const EnsembleRow&)>& onRow);
+
+    // Такт, на котором вид у участника вымер, или -1, если он жив.
+    long long extinctionTick(int member, EntityType species) const;
+    ExtinctionSummary extinctionSummary(EntityType species) const;
+
+private:
+    void emitRow(std::size_t slot, long long tick, const std::function<void(const EnsembleRow&)>& onRow);
+
+    std::vector<EnsembleMember> config;
+    std::vector<Ocean> oceans;
+    std::vector<std::array<long long, 4>> extinction;
+    // Численность за текущую пачку: history[участник * пачка + такт в пачке].
+    std::vector<EntityCounts> history;
+};
+
+#endif
\ No newline at end of file
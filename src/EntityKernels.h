@@ -0,0 +1,278 @@
+#ifndef ENTITY_KERNELS_H
+#define ENTITY_KERNELS_H
+
+#include "CounterRandom.h"
+#include "EntityType.h"
+#include "IOcean.h"
+#include "IWritableOcean.h"
+#include "Intent.h"
+#include "SpeciesParams.h"
+#include "TickStats.h"
+#include <algorithm>
+#include <cstdint>
+
+// Правила видов, записанные как шаблоны над типом сетки. Такт существа
+// разбит на две части. propose читает только текущую сетку (cellAt/ageAt/
+// hungerAt, за краем поля cellAt возвращает BORDER_CELL) и возвращает намерение:
+// остаться, умереть или занять соседнюю клетку — съесть добычу, переплыть на
+// песок, посеять водоросль, — а рыба ещё и клетку песка для малька. apply записывает итог в следующую сетку через put,
+// когда уже известно, досталась ли существу клетка. Ocean между ними разрешает
+// заявки всех существ на каждую клетку по приоритету (см. claimPriority),
+// поэтому результат не зависит от порядка обхода.
+// Случайные числа берутся только из переданного генератора, поэтому ядра
+// можно вызывать из нескольких потоков. Параметры вида передаются последним
+// аргументом: по умолчанию это DefaultSpeciesParams, и константы встраиваются
+// в код так же, как раньше; SpeciesParams читаются из памяти.
+
+class ReadableOceanRef {
+public:
+    explicit ReadableOceanRef(const IOcean& ocean) : ocean(ocean) {}
+
+    EntityType cellAt(int x, int y) const {
+        return ocean.inBounds(x, y) ? ocean.getCellType(x, y) : BORDER_CELL;
+    }
+    int ageAt(int x, int y) const { return ocean.getAge(x, y); }
+    int hungerAt(int x, int y) const { return ocean.getHunger(x, y); }
+
+private:
+    const IOcean& ocean;
+};
+
+class WritableOceanRef {
+public:
+    explicit WritableOceanRef(IWritableOcean& ocean) : ocean(ocean) {}
+
+    EntityType cellAt(int x, int y) const {
+        return ocean.inBounds(x, y) ? ocean.getCellType(x, y) : BORDER_CELL;
+    }
+    void put(int x, int y, EntityType type, int age = 0, int hunger = 0) {
+        ocean.setCell(x, y, type, age, hunger);
+    }
+
+private:
+    IWritableOcean& ocean;
+};
+
+// Генератор для вызовов через интерфейс Entity: у интерфейса нет seed,
+// поэтому каждый поток получает свою фиксированную последовательность.
+inline CounterRandom& entityRandom() {
+    thread_local CounterRandom gen(0, 0);
+    return gen;
+}
+
+// Соседи кодируются битами 8-битной маски в порядке обхода dx, затем dy.
+constexpr int NEIGHBOUR_DX[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+constexpr int NEIGHBOUR_DY[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+inline int countBits(unsigned mask) {
+    mask = mask - ((mask >> 1) & 0x55u);
+    mask = (mask & 0x33u) + ((mask >> 2) & 0x33u);
+    return static_cast<int>((mask + (mask >> 4)) & 0x0Fu);
+}
+
+// Номер k-го (с нуля) установленного бита маски.
+inline int selectBit(unsigned mask, unsigned k) {
+    for (; k > 0; --k) {
+        mask &= mask - 1;
+    }
+    return countBits((mask & (0u - mask)) - 1);
+}
+
+// Случайный установленный бит; маска не должна быть пустой.
+inline int pickBit(unsigned mask, CounterRandom& gen) {
+    return selectBit(mask, gen.below(static_cast<std::uint32_t>(countBits(mask))));
+}
+
+// Один проход по окрестности 3x3 текущей сетки даёт обе маски правил.
+struct Neighbourhood {
+    unsigned prey = 0;      // стоит добыча
+    unsigned sand = 0;      // песок
+};
+
+template <class Current>
+Neighbourhood scanNeighbourhood(int x, int y, const Current& current, EntityType prey) {
+    Neighbourhood result;
+    for (int k = 0; k < 8; ++k) {
+        EntityType now = current.cellAt(x + NEIGHBOUR_DX[k], y + NEIGHBOUR_DY[k]);
+        result.prey |= static_cast<unsigned>(now == prey) << k;
+        result.sand |= static_cast<unsigned>(now == EntityType::Sand) << k;
+    }
+    return result;
+}
+
+// Приоритет заявки существа из ячейки stream в такте с ключом key: из
+// нескольких заявок на клетку побеждает большая. Зависит только от
+// (seed, такт, ячейка), поэтому ни одно направление не выигрывает чаще.
+inline std::uint32_t claimPriority(std::uint64_t key, std::uint64_t stream) {
+    return static_cast<std::uint32_t>(CounterRandom::mix(key ^ CounterRandom::mix(stream ^ 0x636C61696D5EED00ULL)) >> 32);
+}
+
+// Итог такта существа, которое не съели. won — досталась ли ему клетка-цель.
+// Заявка Breed пишет только малька: родителя пишет его основное намерение.
+// beaten — добычу взяла другая рыба того же вида: рыбы, которые идут за одной
+// добычей, дерутся, и проигравшая гибнет. Без этой убыли травоядные в мире
+// по умолчанию съедают все водоросли и вымирают вместе с хищниками.
+template <class Next>
+void applyIntent(const Intent& intent, bool won, Next& next, bool beaten = false) {
+    switch (intent.kind) {
+        case IntentKind::Breed:
+            if (won) {
+                next.put(intent.targetX, intent.targetY, intent.type);
+                noteEvent(next, TickEvent::Birth, intent.type);
+            }
+            return;
+        case IntentKind::DieOfAge:
+        case IntentKind::DieOfHunger:
+            noteEvent(next, intent.kind == IntentKind::DieOfAge ? TickEvent::DeathByAge : TickEvent::DeathByHunger,
+                      intent.type);
+            next.put(intent.x, intent.y, EntityType::Sand);
+            return;
+        case IntentKind::Stay:
+            next.put(intent.x, intent.y, intent.type, intent.age, intent.hunger);
+            return;
+        default:
+            break;
+    }
+    if (!won && beaten && intent.kind == IntentKind::Eat) {
+        noteEvent(next, TickEvent::DeathInFight, intent.type);
+        next.put(intent.x, intent.y, EntityType::Sand);
+        return;
+    }
+    if (!won) {
+        noteEvent(next, TickEvent::Conflict, intent.type);
+        next.put(intent.x, intent.y, intent.type, intent.age, intent.hunger);
+        return;
+    }
+    if (intent.kind == IntentKind::Spawn) {
+        next.put(intent.x, intent.y, intent.type, intent.age, intent.hunger);
+        next.put(intent.targetX, intent.targetY, intent.type);
+        noteEvent(next, TickEvent::Birth, intent.type);
+        return;
+    }
+    bool fed = intent.kind == IntentKind::Eat;
+    next.put(intent.targetX, intent.targetY, intent.type, intent.age, fed ? intent.fedHunger : intent.hunger);
+    noteEvent(next, fed ? TickEvent::Eat : TickEvent::Move, intent.type);
+    next.put(intent.x, intent.y, EntityType::Sand);
+}
+
+template <EntityType Type>
+struct EntityKernel;
+
+// Случайная соседняя клетка из маски становится целью намерения; возвращает её бит.
+inline int aimAt(Intent& intent, unsigned mask, IntentKind kind, CounterRandom& gen) {
+    int k = pickBit(mask, gen);
+    intent.kind = kind;
+    intent.targetX = intent.x + NEIGHBOUR_DX[k];
+    intent.targetY = intent.y + NEIGHBOUR_DY[k];
+    return k;
+}
+
+// Ход одного существа для обёрток Entity, которые обходят поле сами: заявка
+// удаётся, если в следующей сетке цель всё ещё свободна (или там всё ещё
+// добыча), а существо, чью клетку уже занял другой, пропускает ход. Если на
+// месте добычи уже рыба того же вида, добычу взяла она.
+template <class Kernel, class Current, class Next, class Params>
+void tickAlone(int x, int y, const Current& current, Next& next, CounterRandom& gen, const Params& params,
+               EntityType expected) {
+    Intent intent = Kernel::propose(x, y, current, gen, params);
+    EntityType here = next.cellAt(x, y);
+    if (here != EntityType::Sand && here != intent.type) {
+        noteEvent(next, TickEvent::Conflict, intent.type);
+        return;
+    }
+    EntityType target = next.cellAt(intent.targetX, intent.targetY);
+    bool won = intent.claims() && target == (intent.kind == IntentKind::Eat ? expected : EntityType::Sand);
+    applyIntent(intent, won, next, target == intent.type);
+    if (intent.breed && won) {
+        Intent birth = intent.birth();
+        applyIntent(birth, next.cellAt(birth.targetX, birth.targetY) == EntityType::Sand, next);
+    }
+}
+
+template <>
+struct EntityKernel<EntityType::Algae> {
+    template <class Current, class Params = DefaultSpeciesParams<EntityType::Algae>>
+    static Intent propose(int x, int y, const Current& current, CounterRandom& gen, const Params& params = Params{}) {
+        Intent intent;
+        intent.x = intent.targetX = x;
+        intent.y = intent.targetY = y;
+        intent.type = EntityType::Algae;
+        int age = current.ageAt(x, y) + 1;
+        intent.age = static_cast<std::uint16_t>(age);
+        if (age > params.maxAge) {
+            intent.kind = IntentKind::DieOfAge;
+            return intent;
+        }
+        if (age >= params.reproduceAge) {
+            unsigned sand = scanNeighbourhood(x, y, current, EntityType::Sand).sand;
+            if (sand != 0) {
+                aimAt(intent, sand, IntentKind::Spawn, gen);
+            }
+        }
+        return intent;
+    }
+
+    template <class Current, class Next, class Params = DefaultSpeciesParams<EntityType::Algae>>
+    static void tick(int x, int y, const Current& current, Next& next, CounterRandom& gen,
+                     const Params& params = Params{}) {
+        tickAlone<EntityKernel>(x, y, current, next, gen, params, EntityType::Sand);
+    }
+};
+
+// Травоядные и хищники отличаются только добычей и параметрами вида.
+template <EntityType Self, EntityType Prey>
+struct FishKernel {
+    template <class Current, class Params = DefaultSpeciesParams<Self>>
+    static Intent propose(int x, int y, const Current& current, CounterRandom& gen, const Params& params = Params{}) {
+        Intent intent;
+        intent.x = intent.targetX = x;
+        intent.y = intent.targetY = y;
+        intent.type = Self;
+        int age = current.ageAt(x, y) + 1;
+        int hunger = current.hungerAt(x, y) + 1;
+        intent.age = static_cast<std::uint16_t>(age);
+        intent.hunger = static_cast<std::uint16_t>(hunger);
+        if (age > params.maxAge || hunger > params.maxHunger) {
+            intent.kind = age > params.maxAge ? IntentKind::DieOfAge : IntentKind::DieOfHunger;
+            return intent;
+        }
+
+        Neighbourhood around = scanNeighbourhood(x, y, current, Prey);
+        if (around.prey != 0) {
+            aimAt(intent, around.prey, IntentKind::Eat, gen);
+            intent.fedHunger = static_cast<std::uint16_t>(std::max(0, hunger - params.hungerDecrease));
+        } else if (around.sand != 0) {
+            aimAt(intent, around.sand, IntentKind::Move, gen);
+        } else {
+            return intent;
+        }
+        // Малёк занимает клетку песка рядом с новой клеткой родителя; старая
+        // клетка в текущей сетке занята самим родителем и в маску не попадает.
+        if (age >= params.reproduceAge) {
+            unsigned nursery = scanNeighbourhood(intent.targetX, intent.targetY, current, Prey).sand;
+            if (nursery != 0) {
+                int k = pickBit(nursery, gen);
+                intent.breed = true;
+                intent.childX = intent.targetX + NEIGHBOUR_DX[k];
+                intent.childY = intent.targetY + NEIGHBOUR_DY[k];
+            }
+        }
+        return intent;
+    }
+
+    template <class Current, class Next, class Params = DefaultSpeciesParams<Self>>
+    static void tick(int x, int y, const Current& current, Next& next, CounterRandom& gen,
+                     const Params& params = Params{}) {
+        tickAlone<FishKernel>(x, y, current, next, gen, params, Prey);
+    }
+};
+
+template <>
+struct EntityKernel<EntityType::HerbivoreFish>
+    : FishKernel<EntityType::HerbivoreFish, EntityType::Algae> {};
+
+template <>
+struct EntityKernel<EntityType::PredatorFish>
+    : FishKernel<EntityType::PredatorFish, EntityType::HerbivoreFish> {};
+
+#endif
\ No newline at end of file
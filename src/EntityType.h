@@ -1,6 +1,16 @@
 #ifndef ENTITY_TYPE_H
 #define ENTITY_TYPE_H
 
-enum class EntityType { Sand, Algae, HerbivoreFish, PredatorFish };
+#include <array>
+#include <cstdint>
+
+enum class EntityType : std::uint8_t { Sand, Algae, HerbivoreFish, PredatorFish };
+
+// Значение, которое читается за краем поля. Не совпадает ни с одним видом,
+// поэтому туда нельзя ни переместиться, ни отложить потомство.
+constexpr EntityType BORDER_CELL = static_cast<EntityType>(0xFF);
+
+// Численность каждого вида; индекс — значение EntityType.
+using EntityCounts = std::array<long long, 4>;
 
 #endif 
\ No newline at end of file
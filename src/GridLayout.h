@@ -0,0 +1,22 @@
+#ifndef GRID_LAYOUT_H
+#define GRID_LAYOUT_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Порядок ячеек поля в памяти. Linear — строка за строкой. Tiled — блоками
+// 64x64, внутри блока построчно: окрестность 3x3 лежит в одной странице, а не
+// в трёх строках поля. Morton — те же блоки, внутри в Z-порядке: квадрат 8x8
+// занимает одну строку кэша. На результат такта раскладка не влияет.
+enum class GridLayout : std::uint8_t { Linear, Tiled, Morton };
+
+// Разбор имени из командной строки: linear, tiled или morton.
+inline GridLayout parseGridLayout(const std::string& name) {
+    if (name == "linear") return GridLayout::Linear;
+    if (name == "tiled") return GridLayout::Tiled;
+    if (name == "morton") return GridLayout::Morton;
+    throw std::invalid_argument("unknown layout " + name + " (expected linear, tiled or morton)");
+}
+
+#endif
\ No newline at end of file
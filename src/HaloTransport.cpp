@@ -0,0 +1,281 @@
+#include "HaloTransport.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Сколько ждать, пока сосед снизу начнёт слушать.
+constexpr auto CONNECT_TIMEOUT = std::chrono::seconds(60);
+constexpr auto CONNECT_RETRY = std::chrono::milliseconds(20);
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error("SocketTransport: " + what + ": " + std::strerror(errno));
+}
+
+void writeAll(int fd, const std::uint8_t* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            fail("send");
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+void readAll(int fd, std::uint8_t* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t got = ::recv(fd, data, size, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            fail("recv");
+        }
+        if (got == 0) {
+            throw std::runtime_error("SocketTransport: Neighbour closed the connection");
+        }
+        data += got;
+        size -= static_cast<std::size_t>(got);
+    }
+}
+
+// Unix domain: раздел r слушает PATH.r.
+sockaddr_un unixAddress(const std::string& path, int rank) {
+    std::string name = path + "." + std::to_string(rank);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (name.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("SocketTransport: Socket path is too long: " + name);
+    }
+    std::memcpy(address.sun_path, name.c_str(), name.size() + 1);
+    return address;
+}
+
+int listenUnix(const std::string& path, int rank) {
+    sockaddr_un address = unixAddress(path, rank);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) fail("socket");
+    ::unlink(address.sun_path);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 1) < 0) {
+        ::close(fd);
+        fail(std::string("listen on ") + address.sun_path);
+    }
+    return fd;
+}
+
+int connectUnix(const std::string& path, int rank) {
+    sockaddr_un address = unixAddress(path, rank);
+    auto deadline = std::chrono::steady_clock::now() + CONNECT_TIMEOUT;
+    while (true) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) fail("socket");
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            return fd;
+        }
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        if ((errno != ENOENT && errno != ECONNREFUSED) || std::chrono::steady_clock::now() > deadline) {
+            fail(std::string("connect to ") + address.sun_path);
+        }
+        std::this_thread::sleep_for(CONNECT_RETRY);
+    }
+}
+
+addrinfo* resolve(const std::string& host, int port, bool passive) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    addrinfo* result = nullptr;
+    int status = ::getaddrinfo(passive ? nullptr : host.c_str(), std::to_string(port).c_str(), &hints, &result);
+    if (status != 0) {
+        throw std::runtime_error("SocketTransport: Cannot resolve " + host + ": " + ::gai_strerror(status));
+    }
+    return result;
+}
+
+int listenTcp(int port) {
+    addrinfo* address = resolve("", port, true);
+    int fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    int yes = 1;
+    bool ok = fd >= 0 && ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) == 0 &&
+              ::bind(fd, address->ai_addr, address->ai_addrlen) == 0 && ::listen(fd, 1) == 0;
+    ::freeaddrinfo(address);
+    if (!ok) {
+        if (fd >= 0) ::close(fd);
+        fail("listen on port " + std::to_string(port));
+    }
+    return fd;
+}
+
+int connectTcp(const std::string& host, int port) {
+    auto deadline = std::chrono::steady_clock::now() + CONNECT_TIMEOUT;
+    while (true) {
+        addrinfo* address = resolve(host, port, false);
+        int fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        bool ok = fd >= 0 && ::connect(fd, address->ai_addr, address->ai_addrlen) == 0;
+        int error = errno;
+        ::freeaddrinfo(address);
+        if (ok) {
+            return fd;
+        }
+        if (fd >= 0) ::close(fd);
+        errno = error;
+        if (errno != ECONNREFUSED || std::chrono::steady_clock::now() > deadline) {
+            fail("connect to " + host + ":" + std::to_string(port));
+        }
+        std::this_thread::sleep_for(CONNECT_RETRY);
+    }
+}
+
+int acceptOne(int listener) {
+    int fd;
+    do {
+        fd = ::accept(listener, nullptr, nullptr);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) fail("accept");
+    return fd;
+}
+
+// Сообщения короткие и идут по одному на такт: Нейгл только добавил бы задержку.
+void noDelay(int fd) {
+    int yes = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+}
+
+}
+
+SocketTransport::SocketTransport(int above, int below) : above(above), below(below) {}
+
+SocketTransport::~SocketTransport() {
+    if (above >= 0) ::close(above);
+    if (below >= 0) ::close(below);
+}
+
+bool SocketTransport::hasNeighbour(Side side) const {
+    return descriptor(side) >= 0;
+}
+
+void SocketTransport::send(Side side, const std::vector<std::uint8_t>& message) {
+    int fd = descriptor(side);
+    if (fd < 0) {
+        throw std::logic_error("SocketTransport::send: No neighbour on this side");
+    }
+    // Длина — 8 байт от младшего к старшему, затем само сообщение.
+    std::uint8_t header[8];
+    std::uint64_t size = message.size();
+    for (int i = 0; i < 8; ++i) {
+        header[i] = static_cast<std::uint8_t>(size >> (8 * i));
+    }
+    writeAll(fd, header, sizeof(header));
+    writeAll(fd, message.data(), message.size());
+}
+
+void SocketTransport::receive(Side side, std::vector<std::uint8_t>& message) {
+    int fd = descriptor(side);
+    if (fd < 0) {
+        throw std::logic_error("SocketTransport::receive: No neighbour on this side");
+    }
+    std::uint8_t header[8];
+    readAll(fd, header, sizeof(header));
+    std::uint64_t size = 0;
+    for (int i = 0; i < 8; ++i) {
+        size |= static_cast<std::uint64_t>(header[i]) << (8 * i);
+    }
+    message.resize(static_cast<std::size_t>(size));
+    readAll(fd, message.data(), message.size());
+}
+
+std::vector<std::unique_ptr<SocketTransport>> SocketTransport::chain(int ranks) {
+    if (ranks <= 0) {
+        throw std::invalid_argument("SocketTransport::chain: Rank count must be positive.");
+    }
+    std::vector<int> upper(ranks, -1), lower(ranks, -1);
+    for (int r = 0; r + 1 < ranks; ++r) {
+        int pair[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) {
+            for (int fd : upper) if (fd >= 0) ::close(fd);
+            for (int fd : lower) if (fd >= 0) ::close(fd);
+            fail("socketpair");
+        }
+        lower[r] = pair[0];
+        upper[r + 1] = pair[1];
+    }
+    std::vector<std::unique_ptr<SocketTransport>> transports;
+    for (int r = 0; r < ranks; ++r) {
+        transports.push_back(std::make_unique<SocketTransport>(upper[r], lower[r]));
+    }
+    return transports;
+}
+
+std::unique_ptr<SocketTransport> SocketTransport::connect(const std::string& spec, int rank, int ranks) {
+    if (ranks <= 0 || rank < 0 || rank >= ranks) {
+        throw std::invalid_argument("SocketTransport::connect: Rank is out of range.");
+    }
+    bool local = spec.compare(0, 5, "unix:") == 0;
+    std::string path;
+    int port = 0;
+    std::vector<std::string> hosts;
+    if (local) {
+        path = spec.substr(5);
+    } else if (spec.compare(0, 4, "tcp:") == 0) {
+        std::size_t colon = spec.find(':', 4);
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("SocketTransport::connect: Expected tcp:PORT:HOST0,HOST1,...");
+        }
+        port = std::stoi(spec.substr(4, colon - 4));
+        for (std::size_t begin = colon + 1; begin <= spec.size();) {
+            std::size_t comma = spec.find(',', begin);
+            if (comma == std::string::npos) comma = spec.size();
+            hosts.push_back(spec.substr(begin, comma - begin));
+            begin = comma + 1;
+        }
+        if (static_cast<int>(hosts.size()) != ranks) {
+            throw std::invalid_argument("SocketTransport::connect: Need one host per rank.");
+        }
+    } else {
+        throw std::invalid_argument("SocketTransport::connect: Unknown transport '" + spec + "'");
+    }
+
+    // Сначала слушаем, потом подключаемся вниз: connect завершается, как только
+    // соединение встало в очередь, поэтому цепочка не ждёт сама себя.
+    int listener = -1, above = -1, below = -1;
+    try {
+        if (rank > 0) {
+            listener = local ? listenUnix(path, rank) : listenTcp(port + rank);
+        }
+        if (rank + 1 < ranks) {
+            below = local ? connectUnix(path, rank + 1) : connectTcp(hosts[rank + 1], port + rank + 1);
+        }
+        if (listener >= 0) {
+            above = acceptOne(listener);
+            ::close(listener);
+            listener = -1;
+            if (local) {
+                ::unlink(unixAddress(path, rank).sun_path);
+            }
+        }
+    } catch (...) {
+        for (int fd : {listener, above, below}) {
+            if (fd >= 0) ::close(fd);
+        }
+        throw;
+    }
+    if (!local) {
+        if (above >= 0) noDelay(above);
+        if (below >= 0) noDelay(below);
+    }
+    return std::make_unique<SocketTransport>(above, below);
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef HALO_TRANSPORT_H
+#define HALO_TRANSPORT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Канал между соседними разделами OceanPartition: разделы выстроены в цепочку
+// сверху вниз, у каждого не больше двух соседей. Сообщения приходят целиком
+// и в порядке отправки. send может ждать, пока сосед не начнёт читать, поэтому
+// OceanPartition упорядочивает обмен так, чтобы по цепочке не было встречных
+// отправок. Ошибки связи — std::runtime_error.
+class HaloTransport {
+public:
+    enum class Side { Above, Below };
+
+    virtual ~HaloTransport() = default;
+
+    virtual bool hasNeighbour(Side side) const = 0;
+    virtual void send(Side side, const std::vector<std::uint8_t>& message) = 0;
+    virtual void receive(Side side, std::vector<std::uint8_t>& message) = 0;
+};
+
+// Потоковые сокеты: Unix domain на одной машине или TCP между машинами.
+class SocketTransport : public HaloTransport {
+public:
+    // Готовые соединённые сокеты, -1 — соседа нет. Объект их закрывает.
+    SocketTransport(int above, int below);
+    ~SocketTransport() override;
+    SocketTransport(const SocketTransport&) = delete;
+    SocketTransport& operator=(const SocketTransport&) = delete;
+
+    bool hasNeighbour(Side side) const override;
+    void send(Side side, const std::vector<std::uint8_t>& message) override;
+    void receive(Side side, std::vector<std::uint8_t>& message) override;
+
+    // Цепочка из ranks разделов на парах сокетов в одном процессе; годится
+    // для потоков и для fork.
+    static std::vector<std::unique_ptr<SocketTransport>> chain(int ranks);
+    // Подключение раздела rank из ranks по описанию:
+    //   unix:PATH            — разделы на одной машине, раздел r слушает PATH.r;
+    //   tcp:PORT:HOST0,HOST1,... — раздел r слушает порт PORT + r на HOSTr.
+    // Раздел r принимает соединение от r - 1 и сам подключается к r + 1.
+    static std::unique_ptr<SocketTransport> connect(const std::string& spec, int rank, int ranks);
+
+private:
+    int descriptor(Side side) const { return side == Side::Above ? above : below; }
+
+    int above;
+    int below;
+};
+
+#endif
\ No newline at end of file
@@ -7,6 +7,8 @@ class IOcean {
 public:
     virtual ~IOcean() = default;
     virtual EntityType getCellType(int x, int y) const = 0;
+    virtual int getAge(int x, int y) const = 0;
+    virtual int getHunger(int x, int y) const = 0;
     virtual bool inBounds(int x, int y) const = 0;
     virtual int getWidth() const = 0;
     virtual int getHeight() const = 0;
@@ -6,7 +6,9 @@
 
 class IWritableOcean : public IOcean {
 public:
+    // Новая сущность: возраст и голод равны нулю.
     virtual void setCell(int x, int y, EntityType type) = 0;
+    virtual void setCell(int x, int y, EntityType type, int age, int hunger) = 0;
 };
 
 #endif // IWRITABLE_OCEAN_H
\ No newline at end of file
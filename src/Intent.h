@@ -0,0 +1,47 @@
+#ifndef INTENT_H
+#define INTENT_H
+
+#include "EntityType.h"
+#include <cstdint>
+
+enum class IntentKind : std::uint8_t { Stay, Move, Eat, Spawn, Breed, DieOfAge, DieOfHunger };
+
+// Намерение существа на такт. Клетка-цель (targetX, targetY) соседняя: для
+// Move, Spawn и Breed в текущей сетке там песок, для Eat — добыча. Ядро пишет
+// цель без учёта края поля; Ocean переводит её в поле по своей границе.
+// Рыба, готовая к размножению, дополнительно заявляет клетку для малька
+// (childX, childY) рядом со своей целью; Ocean разбирает её отдельной заявкой
+// вида Breed, которая удаётся, только если удалась и заявка родителя.
+struct Intent {
+    int x = 0;
+    int y = 0;
+    int targetX = 0;
+    int targetY = 0;
+    std::uint16_t age = 0;
+    std::uint16_t hunger = 0;
+    std::uint16_t fedHunger = 0;    // голод, если добыча досталась
+    EntityType type = EntityType::Sand;
+    IntentKind kind = IntentKind::Stay;
+    int childX = 0;
+    int childY = 0;
+    bool breed = false;             // есть клетка для малька
+    std::uint8_t claim = 0;         // код заявки в Ocean, см. Ocean::Impl::aim
+    std::uint32_t priority = 0;     // приоритет заявки, см. claimPriority
+
+    bool claims() const {
+        return kind == IntentKind::Move || kind == IntentKind::Eat || kind == IntentKind::Spawn ||
+               kind == IntentKind::Breed;
+    }
+
+    // Отдельная заявка на клетку малька.
+    Intent birth() const {
+        Intent result = *this;
+        result.kind = IntentKind::Breed;
+        result.targetX = childX;
+        result.targetY = childY;
+        result.breed = false;
+        return result;
+    }
+};
+
+#endif
\ No newline at end of file
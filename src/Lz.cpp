@@ -0,0 +1,126 @@
+#include "Lz.h"
+
+#include <cstring>
+#include <stdexcept>
+
+// Формат последовательности: байт-токен (старшие 4 бита — число литералов,
+// младшие — длина совпадения минус 4; значение 15 продолжается байтами по 255),
+// литералы, смещение совпадения (2 байта, little-endian). Последняя
+// последовательность состоит только из литералов.
+namespace {
+
+constexpr std::size_t MIN_MATCH = 4;
+constexpr std::size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 14;
+// Последние байты всегда идут литералами, чтобы поиск не читал за концом.
+constexpr std::size_t TAIL = 8;
+
+std::uint32_t read32(const std::uint8_t* p) {
+    std::uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash(std::uint32_t value) {
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void writeLength(std::vector<std::uint8_t>& out, std::size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(255);
+    }
+    out.push_back(static_cast<std::uint8_t>(length));
+}
+
+void writeSequence(std::vector<std::uint8_t>& out, const std::uint8_t* literals, std::size_t literalCount,
+                   std::size_t offset, std::size_t matchLength) {
+    std::size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH;
+    std::uint8_t token = static_cast<std::uint8_t>((literalCount < 15 ? literalCount : 15) << 4 |
+                                                   (matchCode < 15 ? matchCode : 15));
+    out.push_back(token);
+    if (literalCount >= 15) {
+        writeLength(out, literalCount - 15);
+    }
+    out.insert(out.end(), literals, literals + literalCount);
+    if (matchLength == 0) {
+        return;
+    }
+    out.push_back(static_cast<std::uint8_t>(offset));
+    out.push_back(static_cast<std::uint8_t>(offset >> 8));
+    if (matchCode >= 15) {
+        writeLength(out, matchCode - 15);
+    }
+}
+
+[[noreturn]] void corrupt() {
+    throw std::runtime_error("lzDecompress: Corrupt compressed block");
+}
+
+std::size_t readLength(const std::uint8_t*& in, const std::uint8_t* end, std::size_t length) {
+    if (length != 15) {
+        return length;
+    }
+    std::uint8_t extra;
+    do {
+        if (in >= end) corrupt();
+        extra = *in++;
+        length += extra;
+    } while (extra == 255);
+    return length;
+}
+
+}
+
+void lzCompress(const std::uint8_t* data, std::size_t size, std::vector<std::uint8_t>& out) {
+    std::vector<std::uint32_t> table(std::size_t{1} << HASH_BITS, 0);
+    std::size_t anchor = 0;
+    std::size_t i = 0;
+    std::size_t limit = size > TAIL ? size - TAIL : 0;
+    while (i < limit) {
+        std::uint32_t value = read32(data + i);
+        std::uint32_t& slot = table[hash(value)];
+        std::size_t candidate = slot;
+        slot = static_cast<std::uint32_t>(i);
+        if (candidate >= i || i - candidate > MAX_OFFSET || read32(data + candidate) != value) {
+            ++i;
+            continue;
+        }
+        std::size_t length = MIN_MATCH;
+        while (i + length < limit && data[candidate + length] == data[i + length]) {
+            ++length;
+        }
+        writeSequence(out, data + anchor, i - anchor, i - candidate, length);
+        i += length;
+        anchor = i;
+    }
+    writeSequence(out, data + anchor, size - anchor, 0, 0);
+}
+
+void lzDecompress(const std::uint8_t* data, std::size_t size, std::uint8_t* out, std::size_t rawSize) {
+    const std::uint8_t* in = data;
+    const std::uint8_t* end = data + size;
+    std::size_t written = 0;
+    while (in < end) {
+        std::uint8_t token = *in++;
+        std::size_t literals = readLength(in, end, token >> 4);
+        if (literals > static_cast<std::size_t>(end - in) || literals > rawSize - written) corrupt();
+        std::memcpy(out + written, in, literals);
+        in += literals;
+        written += literals;
+        if (in == end) {
+            break;
+        }
+        if (end - in < 2) corrupt();
+        std::size_t offset = in[0] | static_cast<std::size_t>(in[1]) << 8;
+        in += 2;
+        std::size_t length = readLength(in, end, token & 15) + MIN_MATCH;
+        if (offset == 0 || offset > written || length > rawSize - written) corrupt();
+        // Совпадение может перекрываться с самим собой, поэтому копируем по байту.
+        const std::uint8_t* from = out + written - offset;
+        for (std::size_t k = 0; k < length; ++k) {
+            out[written + k] = from[k];
+        }
+        written += length;
+    }
+    if (written != rawSize) corrupt();
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef LZ_H
+#define LZ_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Быстрое блочное сжатие в духе LZ4: последовательности «литералы + ссылка
+// назад на совпадение не короче 4 байт» без энтропийного кодирования.
+// Предназначено для кадров траектории, где много повторов.
+
+// Дописывает сжатый блок в конец out.
+void lzCompress(const std::uint8_t* data, std::size_t size, std::vector<std::uint8_t>& out);
+
+// Распаковывает блок ровно в rawSize байт; при повреждённых данных
+// бросает std::runtime_error и не пишет за пределы out.
+void lzDecompress(const std::uint8_t* data, std::size_t size, std::uint8_t* out, std::size_t rawSize);
+
+#endif
\ No newline at end of file
@@ -1,54 +1,543 @@
 #include "Ocean.h"
-#include "Sand.h"          
-#include "Algae.h"         
-#include "HerbivoreFish.h" 
-#include "PredatorFish.h"  
-#include "Entity.h" 
+#include "EntityKernels.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept> 
 
-Ocean::Impl::Impl(int width, int height) : width(width), height(height) {
-    grid.resize(width);
-    for (int i = 0; i < width; ++i) {
-        grid[i].resize(height);
-        for (int j = 0; j < height; ++j) {
-            grid[i][j] = EntityType::Sand;
+namespace {
+
+// Откуда tickCells берёт параметры видов: встроенные константы или EcosystemParams.
+struct DefaultRules {
+    template <EntityType Type>
+    DefaultSpeciesParams<Type> of() const { return {}; }
+};
+
+struct RuntimeRules {
+    const EcosystemParams& params;
+
+    template <EntityType Type>
+    const SpeciesParams& of() const { return params[Type]; }
+};
+
+// Биты v на чётных позициях: координата в Z-порядке.
+std::size_t spreadBits(int v) {
+    std::size_t result = 0;
+    for (int bit = 0; v >> bit; ++bit) {
+        result |= static_cast<std::size_t>((v >> bit) & 1) << (2 * bit);
+    }
+    return result;
+}
+
+}
+
+Ocean::Buffer::Buffer(int width, int height, ChangeLog* log, GridLayout layout, bool allocate)
+    : width(width), height(height), layout(layout), stride(static_cast<std::size_t>(width) + 2), log(log) {
+    // Смещения считаются в координатах с рамкой: 0 — рамка слева (сверху).
+    std::size_t columns = static_cast<std::size_t>(width) + 2;
+    std::size_t rows = static_cast<std::size_t>(height) + 2;
+    columnBase.resize(columns);
+    rowBase.resize(rows);
+    if (layout == GridLayout::Linear) {
+        for (std::size_t x = 0; x < columns; ++x) columnBase[x] = x;
+        for (std::size_t y = 0; y < rows; ++y) rowBase[y] = y * columns;
+        cellCount = columns * rows;
+    } else {
+        // Блок TILE_SIZE x TILE_SIZE лежит подряд; блоки идут построчно.
+        const std::size_t side = TILE_SIZE;
+        std::size_t blocksX = (columns + side - 1) / side;
+        std::size_t blocksY = (rows + side - 1) / side;
+        bool morton = layout == GridLayout::Morton;
+        for (std::size_t x = 0; x < columns; ++x) {
+            int inside = static_cast<int>(x % side);
+            columnBase[x] = x / side * side * side + (morton ? spreadBits(inside) : inside);
+        }
+        for (std::size_t y = 0; y < rows; ++y) {
+            int inside = static_cast<int>(y % side);
+            rowBase[y] = y / side * blocksX * side * side + (morton ? spreadBits(inside) << 1 : inside * side);
+        }
+        cellCount = blocksX * blocksY * side * side;
+    }
+    if (!allocate) {
+        return;
+    }
+    cells = CellArray<EntityType>(cellCount, BORDER_CELL);
+    age = CellArray<std::uint16_t>(cellCount, 0);
+    hunger = CellArray<std::uint16_t>(cellCount, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            cells[index(x, y)] = EntityType::Sand;
         }
     }
 }
 
-Ocean::Impl::Impl(const Impl& other) : width(other.width), height(other.height), grid(other.grid) {}
+Ocean::Buffer::Buffer(const Buffer& other, ChangeLog* log)
+    : width(other.width), height(other.height), layout(other.layout), stride(other.stride), cellCount(other.cellCount),
+      rowBase(other.rowBase), columnBase(other.columnBase),
+      cells(other.cells), age(other.age), hunger(other.hunger), log(log) {}
+
+const EntityType* Ocean::Buffer::row(int y, std::vector<EntityType>& scratch) const {
+    if (layout == GridLayout::Linear) {
+        return cells.data() + index(0, y);
+    }
+    scratch.resize(static_cast<std::size_t>(width));
+    copyRow(y, scratch.data());
+    return scratch.data();
+}
 
-EntityType Ocean::Impl::getCellType(int x, int y) const {
+void Ocean::Buffer::copyRow(int y, EntityType* out) const {
+    if (layout == GridLayout::Linear) {
+        std::copy_n(cells.data() + index(0, y), width, out);
+        return;
+    }
+    // Строка блока лежит подряд только в Tiled; Morton собирается по ячейке.
+    const std::size_t base = rowBase[static_cast<std::size_t>(y) + 1];
+    for (int x = 0; x < width; ++x) {
+        out[x] = cells[base + columnBase[static_cast<std::size_t>(x) + 1]];
+    }
+}
+
+EntityType Ocean::Buffer::getCellType(int x, int y) const {
+    if (!inBounds(x, y)) {
+        throw std::out_of_range("Ocean::Buffer::getCellType: Coordinates out of bounds");
+    }
+    return cells[index(x, y)];
+}
+
+int Ocean::Buffer::getAge(int x, int y) const {
     if (!inBounds(x, y)) {
-        throw std::out_of_range("Ocean::Impl::getCellType: Coordinates out of bounds");
+        throw std::out_of_range("Ocean::Buffer::getAge: Coordinates out of bounds");
     }
-    return grid[x][y];
+    return age[index(x, y)];
 }
 
-void Ocean::Impl::setCell(int x, int y, EntityType type) {
+int Ocean::Buffer::getHunger(int x, int y) const {
     if (!inBounds(x, y)) {
-        throw std::out_of_range("Ocean::Impl::setCell: Coordinates out of bounds");
+        throw std::out_of_range("Ocean::Buffer::getHunger: Coordinates out of bounds");
     }
-    grid[x][y] = type;
+    return hunger[index(x, y)];
 }
 
-bool Ocean::Impl::inBounds(int x, int y) const {
+void Ocean::Buffer::setCell(int x, int y, EntityType type) {
+    setCell(x, y, type, 0, 0);
+}
+
+void Ocean::Buffer::setCell(int x, int y, EntityType type, int age, int hunger) {
+    if (!inBounds(x, y)) {
+        throw std::out_of_range("Ocean::Buffer::setCell: Coordinates out of bounds");
+    }
+    std::size_t i = index(x, y);
+    store(i, type, age, hunger);
+    log->note(i);
+}
+
+bool Ocean::Buffer::inBounds(int x, int y) const {
     return x >= 0 && x < width && y >= 0 && y < height;
 }
 
-int Ocean::Impl::getWidth() const { return width; }
-int Ocean::Impl::getHeight() const { return height; }
+int Ocean::Buffer::getWidth() const { return width; }
+int Ocean::Buffer::getHeight() const { return height; }
+
+void Ocean::Buffer::swapContents(Buffer& other) {
+    cells.swap(other.cells);
+    age.swap(other.age);
+    hunger.swap(other.hunger);
+}
+
+void Ocean::TileGrid::splitAxis(int size, int first, std::vector<int>& start, std::vector<int>& tileOf) {
+    start.assign(1, 0);
+    for (int edge = first; edge < size - 1; edge += TILE_SIZE) {
+        start.push_back(edge);
+    }
+    int count = static_cast<int>(start.size());
+    start.push_back(size);
+    tileOf.resize(size);
+    for (int k = 0; k < count; ++k) {
+        std::fill(tileOf.begin() + start[k], tileOf.begin() + start[k + 1], k);
+    }
+}
+
+Ocean::TileGrid::TileGrid(int width, int height, int first) {
+    splitAxis(width, first, columnStart, columnOf);
+    splitAxis(height, first, rowStart, rowOf);
+    tilesX = static_cast<int>(columnStart.size()) - 1;
+    tilesY = static_cast<int>(rowStart.size()) - 1;
+}
+
+Ocean::Impl::Impl(int width, int height, std::uint64_t seed, Boundary boundary, GridLayout layout, bool allocate)
+    : boundary(boundary), tiles(width, height, layout == GridLayout::Linear ? TILE_SIZE : TILE_SIZE - 1),
+      workers(1), front(width, height, &workers[0].log, layout, allocate),
+      back(width, height, &workers[0].log, layout, allocate), seed(seed) {
+    workers[0].log.limit = front.cellCount / 8;
+    workers[0].touched.flags.assign(static_cast<std::size_t>(tiles.count()), 0);
+    workers[0].claimed.flags.assign(static_cast<std::size_t>(tiles.count()), 0);
+    active.flags.assign(static_cast<std::size_t>(tiles.count()), 0);
+    proposed.flags = active.flags;
+    resolving.flags = active.flags;
+    intents.resize(static_cast<std::size_t>(tiles.count()));
+    counts[static_cast<std::size_t>(EntityType::Sand)] = static_cast<long long>(width) * height;
+}
+
+Ocean::Impl::Impl(int width, int rows, int rowOffset, std::uint64_t seed)
+    : boundary(Boundary::Walls), tiles(width, rows),
+      workers(1), front(width, rows, &workers[0].log), back(width, rows, &workers[0].log),
+      seed(seed), rowOffset(rowOffset) {
+    workers[0].log.limit = front.cellCount / 8;
+    workers[0].touched.flags.assign(static_cast<std::size_t>(tiles.count()), 0);
+    workers[0].claimed.flags.assign(static_cast<std::size_t>(tiles.count()), 0);
+    active.flags.assign(static_cast<std::size_t>(tiles.count()), 0);
+    proposed.flags = active.flags;
+    resolving.flags = active.flags;
+    intents.resize(static_cast<std::size_t>(tiles.count()));
+    counts[static_cast<std::size_t>(EntityType::Sand)] = static_cast<long long>(width) * rows;
+}
+
+Ocean::Impl::Impl(const Impl& other)
+    : boundary(other.boundary), tiles(other.tiles), workers(other.workers), counts(other.counts),
+      front(other.front, &workers[0].log), back(other.back, &workers[0].log), active(other.active),
+      seed(other.seed), tickCount(other.tickCount), fillCount(other.fillCount),
+      params(other.params), customParams(other.customParams), version(other.version),
+      summedVersion(other.summedVersion.load()), trackSummedArea(other.trackSummedArea), summedArea(other.summedArea),
+      rowOffset(other.rowOffset) {
+    proposed.flags.assign(active.flags.size(), 0);
+    resolving.flags.assign(active.flags.size(), 0);
+    intents.resize(active.flags.size());
+    if (other.pool) {
+        pool = std::make_unique<ThreadPool>(other.pool->size());
+    }
+}
+
+void Ocean::Impl::setThreadCount(int threadCount) {
+    if (threadCount <= 0) {
+        throw std::invalid_argument("Ocean::setThreadCount: Thread count must be positive.");
+    }
+    // Журналы изменений лишних потоков пропали бы вместе с ними, и задний
+    // буфер остался бы с устаревшими клетками: переносим их сейчас.
+    syncBack();
+    pool = threadCount > 1 ? std::make_unique<ThreadPool>(threadCount) : nullptr;
+    std::size_t limit = workers[0].log.limit;
+    workers.resize(threadCount);
+    for (WorkerState& worker : workers) {
+        worker.log.limit = limit;
+        worker.touched.flags.resize(active.flags.size(), 0);
+        worker.claimed.flags.resize(active.flags.size(), 0);
+    }
+    front.log = &workers[0].log;
+    back.log = &workers[0].log;
+}
+
+void Ocean::Impl::syncBack() {
+    bool overflow = false;
+    for (const WorkerState& worker : workers) {
+        overflow = overflow || worker.log.overflow;
+    }
+    if (overflow) {
+        std::copy(front.cells.begin(), front.cells.end(), back.cells.begin());
+        std::copy(front.age.begin(), front.age.end(), back.age.begin());
+        std::copy(front.hunger.begin(), front.hunger.end(), back.hunger.begin());
+    } else {
+        for (const WorkerState& worker : workers) {
+            for (std::size_t i : worker.log.indices) {
+                back.cells[i] = front.cells[i];
+                back.age[i] = front.age[i];
+                back.hunger[i] = front.hunger[i];
+            }
+        }
+    }
+    for (WorkerState& worker : workers) {
+        worker.log.indices.clear();
+        worker.log.overflow = false;
+    }
+}
+
+void Ocean::Impl::collectWorkers() {
+    for (WorkerState& worker : workers) {
+        for (std::size_t type = 0; type < counts.size(); ++type) {
+            counts[type] += worker.delta[type];
+        }
+        worker.delta.fill(0);
+        for (int tile : worker.touched.tiles) {
+            active.insert(tile);
+        }
+        worker.touched.clear();
+        if constexpr (STATS_ENABLED) {
+            stats.merge(worker.stats);
+            worker.stats = TickStats{};
+        }
+    }
+}
+
+void Ocean::Impl::markActive(int x, int y) {
+    active.insert(tiles.tileOf(x, y));
+}
+
+template <class Fn>
+void Ocean::Impl::forTiles(const std::vector<int>& list, Fn fn) {
+    auto task = [&](std::size_t i, int worker) {
+        fn(list[i], workers[worker]);
+    };
+    if (pool) {
+        pool->parallelFor(list.size(), task);
+    } else {
+        for (std::size_t i = 0; i < list.size(); ++i) {
+            task(i, 0);
+        }
+    }
+}
+
+void Ocean::Impl::proposeTile(int tile, WorkerState& worker) {
+    if (front.layout == GridLayout::Linear) {
+        proposeIn(tile, BufferView<true>{front}, worker);
+    } else {
+        proposeIn(tile, BufferView<false>{front}, worker);
+    }
+}
+
+template <class View>
+void Ocean::Impl::proposeIn(int tile, const View& cells, WorkerState& worker) {
+    int tileX = tile % tiles.tilesX;
+    int tileY = tile / tiles.tilesX;
+    bool edge = tileX == 0 || tileY == 0 || tileX == tiles.tilesX - 1 || tileY == tiles.tilesY - 1;
+    // Заворачивать координаты нужно только у края; внутри плитки читают буфер напрямую.
+    if (edge && boundary == Boundary::Torus) {
+        BoundaryGrid<const View, TorusBoundary> current(cells, front.width, front.height);
+        proposeWith(tile, cells, current, worker);
+    } else if (edge && boundary == Boundary::Reflect) {
+        BoundaryGrid<const View, ReflectBoundary> current(cells, front.width, front.height);
+        proposeWith(tile, cells, current, worker);
+    } else {
+        proposeWith(tile, cells, cells, worker);
+    }
+}
+
+template <class View, class Current>
+void Ocean::Impl::proposeWith(int tile, const View& cells, const Current& current, WorkerState& worker) {
+    if (customParams) {
+        proposeCells(tile, cells, current, worker, RuntimeRules{params});
+    } else {
+        proposeCells(tile, cells, current, worker, DefaultRules{});
+    }
+}
+
+template <class Rules, class View, class Current>
+void Ocean::Impl::proposeCells(int tile, const View& cells, const Current& current, WorkerState& worker,
+                               const Rules& rules) {
+    int tileX = tile % tiles.tilesX;
+    int tileY = tile / tiles.tilesX;
+    TileIntents& out = intents[tile];
+    out.intents.clear();
+    for (int round = 0; round < CLAIM_ROUNDS; ++round) {
+        out.inside[round].clear();
+        out.crossing[round].clear();
+    }
+    auto submit = [&](Intent intent) {
+        if (intent.claims()) {
+            aim(intent);
+            int round = static_cast<int>(roundOf(intent));
+            int target = tiles.tileOf(intent.targetX, intent.targetY);
+            auto number = static_cast<std::uint32_t>(out.intents.size());
+            if (target == tile) {
+                out.inside[round].push_back(number);
+            } else {
+                out.crossing[round].push_back(number);
+                worker.claimed.insert(target);
+            }
+        }
+        out.intents.push_back(intent);
+    };
+    // Время вида включает и проход по песку перед каждым существом.
+    TickTimer timer;
+
+    for (int y = tiles.rowStart[tileY]; y < tiles.rowStart[tileY + 1]; ++y) {
+        for (int x = tiles.columnStart[tileX]; x < tiles.columnStart[tileX + 1]; ++x) {
+            EntityType type = cells.cellAt(x, y);
+            if (type == EntityType::Sand) {
+                continue;
+            }
+            CounterRandom gen(tickKey, static_cast<std::uint64_t>(y + rowOffset) * front.width + x);
+            Intent intent;
+            switch (type) {
+                case EntityType::Algae:
+                    intent = EntityKernel<EntityType::Algae>::propose(x, y, current, gen,
+                                                                      rules.template of<EntityType::Algae>());
+                    break;
+                case EntityType::HerbivoreFish:
+                    intent = EntityKernel<EntityType::HerbivoreFish>::propose(x, y, current, gen,
+                                                                              rules.template of<EntityType::HerbivoreFish>());
+                    break;
+                case EntityType::PredatorFish:
+                    intent = EntityKernel<EntityType::PredatorFish>::propose(x, y, current, gen,
+                                                                             rules.template of<EntityType::PredatorFish>());
+                    break;
+                default:
+                    continue;
+            }
+            submit(intent);
+            if (intent.breed) {
+                submit(intent.birth());
+            }
+            timer.lap(worker.stats.speciesSeconds[static_cast<std::size_t>(type)]);
+        }
+    }
+}
+
+void Ocean::Impl::aim(Intent& intent) const {
+    int dx = intent.x - intent.targetX;
+    int dy = intent.y - intent.targetY;
+    if (boundary == Boundary::Torus) {
+        intent.targetX = TorusBoundary::map(intent.targetX, front.width);
+        intent.targetY = TorusBoundary::map(intent.targetY, front.height);
+    } else if (boundary == Boundary::Reflect) {
+        intent.targetX = ReflectBoundary::map(intent.targetX, front.width);
+        intent.targetY = ReflectBoundary::map(intent.targetY, front.height);
+        dx = intent.x - intent.targetX;
+        dy = intent.y - intent.targetY;
+    }
+    // Код — положение источника относительно цели, от 1 до 25: малёк бывает
+    // в двух клетках от родителя. По цели и коду восстанавливается источник,
+    // а у одной цели коды разных заявок различны.
+    intent.claim = static_cast<std::uint8_t>((dx + 2) * 5 + (dy + 2) + 1);
+    intent.priority = priorityAt(intent.x, intent.y);
+}
+
+// Приоритет победителя лежит рядом с его кодом, поэтому источник заявки
+// восстанавливать не нужно. При равных приоритетах решает код заявки.
+bool Ocean::Impl::outranks(const Intent& intent, std::size_t cell) const {
+    std::uint32_t theirs = claimPriorities[cell];
+    return intent.priority != theirs ? intent.priority > theirs : intent.claim > claims[cell];
+}
+
+bool Ocean::Impl::catches(const Intent& intent) const {
+    return intent.priority > priorityAt(intent.targetX, intent.targetY);
+}
+
+std::uint32_t Ocean::Impl::priorityAt(int x, int y) const {
+    return claimPriority(tickKey, static_cast<std::uint64_t>(y + rowOffset) * front.width + x);
+}
+
+Ocean::Impl::ClaimRound Ocean::Impl::roundOf(const Intent& intent) {
+    if (intent.kind != IntentKind::Eat) {
+        return ClaimRound::Free;
+    }
+    return intent.type == EntityType::PredatorFish ? ClaimRound::PredatorsEat : ClaimRound::HerbivoresEat;
+}
+
+template <class Fn>
+void Ocean::Impl::forEachIncoming(int tile, ClaimRound round, Fn fn) const {
+    int tileX = tile % tiles.tilesX;
+    int tileY = tile / tiles.tilesX;
+    int x0 = tiles.columnStart[tileX], x1 = tiles.columnStart[tileX + 1];
+    int y0 = tiles.rowStart[tileY], y1 = tiles.rowStart[tileY + 1];
+    auto inside = [&](const Intent& intent) {
+        return intent.targetX >= x0 && intent.targetX < x1 && intent.targetY >= y0 && intent.targetY < y1;
+    };
+    int r = static_cast<int>(round);
+    if (proposed.flags[tile]) {
+        const TileIntents& own = intents[tile];
+        for (std::uint32_t i : own.inside[r]) {
+            fn(own.intents[i]);
+        }
+    }
+    // Заявки через край плитки приходят только из восьми соседних плиток; на
+    // торе соседи берутся через край поля, и одна плитка может встретиться дважды.
+    bool wrap = boundary == Boundary::Torus;
+    int neighbours[8];
+    int count = 0;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            int nx = tileX + dx;
+            int ny = tileY + dy;
+            if (wrap) {
+                nx = TorusBoundary::map(nx, tiles.tilesX);
+                ny = TorusBoundary::map(ny, tiles.tilesY);
+            }
+            if (nx < 0 || ny < 0 || nx >= tiles.tilesX || ny >= tiles.tilesY) {
+                continue;
+            }
+            int neighbour = ny * tiles.tilesX + nx;
+            if (neighbour != tile && proposed.flags[neighbour] &&
+                std::find(neighbours, neighbours + count, neighbour) == neighbours + count) {
+                neighbours[count++] = neighbour;
+            }
+        }
+    }
+    for (int k = 0; k < count; ++k) {
+        const TileIntents& from = intents[neighbours[k]];
+        for (std::uint32_t i : from.crossing[r]) {
+            if (inside(from.intents[i])) fn(from.intents[i]);
+        }
+    }
+}
+
+void Ocean::Impl::claimTile(int tile, ClaimRound round) {
+    // Съеденное в прошлом раунде существо уже не претендует на клетки.
+    auto alive = [&](const Intent& intent) {
+        return intent.type == EntityType::PredatorFish || claims[front.index(intent.x, intent.y)] == 0;
+    };
+    forEachIncoming(tile, round, [&](const Intent& intent) {
+        if (round == ClaimRound::PredatorsEat ? !catches(intent) : !alive(intent)) {
+            return;
+        }
+        std::size_t cell = front.index(intent.targetX, intent.targetY);
+        if (claims[cell] == 0 || outranks(intent, cell)) {
+            claims[cell] = intent.claim;
+            claimPriorities[cell] = intent.priority;
+        }
+    });
+}
+
+void Ocean::Impl::applyTile(int tile, WorkerState& worker) {
+    Writer next(back, worker, tiles);
+    TickTimer timer;
+    // Заявка малька идёт сразу за заявкой родителя и удаётся, только если
+    // родитель добрался до своей новой клетки.
+    bool parentMoved = false;
+    for (const Intent& intent : intents[tile].intents) {
+        if (intent.type != EntityType::PredatorFish && claims[front.index(intent.x, intent.y)] != 0) {
+            continue;   // съеден; клетку пишет победитель
+        }
+        std::uint8_t winner = intent.claims() ? claims[front.index(intent.targetX, intent.targetY)] : 0;
+        bool won = winner != 0 && winner == intent.claim;
+        if (intent.kind == IntentKind::Breed) {
+            won = won && parentMoved;
+        } else {
+            parentMoved = won;
+        }
+        // На клетку добычи заявляют только едоки одного вида, так что чужой
+        // победитель там — соперник.
+        applyIntent(intent, won, next, winner != 0);
+        timer.lap(worker.stats.speciesSeconds[static_cast<std::size_t>(intent.type)]);
+    }
+}
 
+void Ocean::Impl::clearTile(int tile) {
+    for (ClaimRound round : {ClaimRound::PredatorsEat, ClaimRound::HerbivoresEat, ClaimRound::Free}) {
+        forEachIncoming(tile, round, [&](const Intent& intent) {
+            claims[front.index(intent.targetX, intent.targetY)] = 0;
+        });
+    }
+}
 
-Ocean::Ocean(int width, int height) {
+Ocean::Ocean(int width, int height, std::uint64_t seed, Boundary boundary, GridLayout layout) {
     if (width <= 0 || height <= 0) {
         throw std::invalid_argument("Ocean: Width and height must be positive.");
     }
-    pimpl = std::make_unique<Impl>(width, height);
+    if (boundary != Boundary::Walls && (width < 3 || height < 3)) {
+        throw std::invalid_argument("Ocean: Wrapping boundaries need a grid of at least 3x3.");
+    }
+    if (boundary != Boundary::Walls && boundary != Boundary::Torus && boundary != Boundary::Reflect) {
+        throw std::invalid_argument("Ocean: Unknown boundary mode.");
+    }
+    if (layout != GridLayout::Linear && layout != GridLayout::Tiled && layout != GridLayout::Morton) {
+        throw std::invalid_argument("Ocean: Unknown grid layout.");
+    }
+    pimpl = std::make_unique<Impl>(width, height, seed, boundary, layout);
 }
 
+Ocean::Ocean(std::unique_ptr<Impl> impl) : pimpl(std::move(impl)) {}
+
 Ocean::~Ocean() = default;
 
 Ocean::Ocean(const Ocean& other)
@@ -67,93 +556,396 @@ Ocean& Ocean::operator=(const Ocean& other) {
 Ocean& Ocean::operator=(Ocean&& other) noexcept = default;
 
 EntityType Ocean::getCellType(int x, int y) const {
-    return pimpl->getCellType(x, y);
+    return pimpl->front.getCellType(x, y);
+}
+
+int Ocean::getAge(int x, int y) const {
+    return pimpl->front.getAge(x, y);
+}
+
+int Ocean::getHunger(int x, int y) const {
+    return pimpl->front.getHunger(x, y);
 }
 
 void Ocean::setCell(int x, int y, EntityType type) {
-    pimpl->setCell(x, y, type);
+    setCell(x, y, type, 0, 0);
+}
+
+void Ocean::setCell(int x, int y, EntityType type, int age, int hunger) {
+    if (static_cast<std::size_t>(type) >= pimpl->counts.size()) {
+        throw std::invalid_argument("Ocean::setCell: Unknown entity type.");
+    }
+    EntityType old = pimpl->front.getCellType(x, y);
+    pimpl->front.setCell(x, y, type, age, hunger);
+    ++pimpl->version;
+    --pimpl->counts[static_cast<std::size_t>(old)];
+    ++pimpl->counts[static_cast<std::size_t>(type)];
+    if (type != EntityType::Sand) {
+        pimpl->markActive(x, y);
+    }
 }
 
 bool Ocean::inBounds(int x, int y) const {
-    return pimpl->inBounds(x, y);
+    return pimpl->front.inBounds(x, y);
 }
 
 int Ocean::getWidth() const {
-    return pimpl->getWidth();
+    return pimpl->front.width;
 }
 
 int Ocean::getHeight() const {
-    return pimpl->getHeight();
+    return pimpl->front.height;
+}
+
+const TickStats& Ocean::getStats() const {
+    return pimpl->stats;
+}
+
+void Ocean::resetStats() {
+    pimpl->stats = TickStats{};
+}
+
+void Ocean::setSpeciesParams(const EcosystemParams& params) {
+    params.validate();
+    pimpl->params = params;
+    pimpl->customParams = !params.isDefault();
+}
+
+const EcosystemParams& Ocean::getSpeciesParams() const {
+    return pimpl->params;
+}
+
+Boundary Ocean::getBoundary() const {
+    return pimpl->boundary;
+}
+
+GridLayout Ocean::getLayout() const {
+    return pimpl->front.layout;
 }
 
 void Ocean::tick() {
-    Ocean nextOcean(getWidth(), getHeight());
+    Impl& impl = *pimpl;
+    TickTimer timer;
+    impl.syncBack();
+    timer.lap(impl.stats.syncSeconds);
 
-    for (int x = 0; x < getWidth(); ++x) {
-        for (int y = 0; y < getHeight(); ++y) {
-            nextOcean.setCell(x, y, getCellType(x, y));
+    // Любая клетка, куда существо попадёт в этом такте, отмечается Writer,
+    // поэтому после такта active снова содержит все плитки с существами.
+    impl.proposed.clear();
+    for (int tile : impl.active.tiles) {
+        impl.proposed.insert(tile);
+    }
+    impl.active.clear();
+    if (impl.claims.size() != impl.front.cells.size()) {
+        impl.claims.assign(impl.front.cells.size(), 0);
+        impl.claimPriorities.assign(impl.front.cells.size(), 0);
+    }
+    impl.tickKey = CounterRandom::key(impl.seed, static_cast<std::uint64_t>(impl.tickCount));
+    timer.lap(impl.stats.scheduleSeconds);
+
+    impl.forTiles(impl.proposed.tiles, [&](int tile, WorkerState& worker) {
+        impl.proposeTile(tile, worker);
+    });
+    // Разбирать заявки нужно и в пустых плитках, куда целят соседи.
+    impl.resolving.clear();
+    for (int tile : impl.proposed.tiles) {
+        impl.resolving.insert(tile);
+    }
+    for (WorkerState& worker : impl.workers) {
+        for (int tile : worker.claimed.tiles) {
+            impl.resolving.insert(tile);
         }
+        worker.claimed.clear();
+    }
+    // Каждая плитка пишет в claims только свои клетки, поэтому плитки одного
+    // раунда независимы.
+    for (Impl::ClaimRound round : {Impl::ClaimRound::PredatorsEat, Impl::ClaimRound::HerbivoresEat,
+                                   Impl::ClaimRound::Free}) {
+        impl.forTiles(impl.resolving.tiles, [&](int tile, WorkerState&) {
+            impl.claimTile(tile, round);
+        });
     }
+    impl.forTiles(impl.proposed.tiles, [&](int tile, WorkerState& worker) {
+        impl.applyTile(tile, worker);
+    });
+    impl.forTiles(impl.resolving.tiles, [&](int tile, WorkerState&) {
+        impl.clearTile(tile);
+    });
 
-    for (int x = 0; x < getWidth(); ++x) {
-        for (int y = 0; y < getHeight(); ++y) {
-            EntityType type = getCellType(x, y);
-            std::unique_ptr<Entity> entity; 
+    timer.lap(impl.stats.updateSeconds);
 
-            switch (type) {
-                case EntityType::Algae:
-                    entity = std::make_unique<Algae>();
-                    break;
-                case EntityType::HerbivoreFish:
-                    entity = std::make_unique<HerbivoreFish>();
-                    break;
-                case EntityType::PredatorFish:
-                    entity = std::make_unique<PredatorFish>();
-                    break;
-                case EntityType::Sand:
-                    continue;
-                default:
-                    throw std::runtime_error("Ocean::tick: Unknown entity type encountered.");
+    impl.front.swapContents(impl.back);
+    impl.collectWorkers();
+    ++impl.tickCount;
+    ++impl.version;
+    if (impl.trackSummedArea) {
+        impl.refreshSummedArea();
+    }
+    if constexpr (STATS_ENABLED) {
+        ++impl.stats.ticks;
+    }
+    timer.lap(impl.stats.mergeSeconds);
+}
+
+void Ocean::setThreadCount(int threadCount) {
+    pimpl->setThreadCount(threadCount);
+}
+
+int Ocean::getThreadCount() const {
+    return pimpl->pool ? pimpl->pool->size() : 1;
+}
+
+std::uint64_t Ocean::getSeed() const {
+    return pimpl->seed;
+}
+
+long long Ocean::getTickCount() const {
+    return pimpl->tickCount;
+}
+
+void Ocean::randomFill(int algaeCount, int herbivoreCount, int predatorCount) {
+    pimpl->fill(algaeCount, herbivoreCount, predatorCount, nullptr);
+}
+
+void Ocean::randomFill(int algaeCount, int herbivoreCount, int predatorCount, const std::vector<float>& density) {
+    if (density.size() != static_cast<std::size_t>(getWidth()) * getHeight()) {
+        throw std::invalid_argument("Ocean::randomFill: Density map must have one weight per cell.");
+    }
+    pimpl->fill(algaeCount, herbivoreCount, predatorCount, &density);
+}
+
+void Ocean::Impl::place(int x, int y, EntityType type) {
+    std::size_t i = front.index(x, y);
+    --counts[static_cast<std::size_t>(front.cells[i])];
+    ++counts[static_cast<std::size_t>(type)];
+    front.store(i, type, 0, 0);
+    front.log->note(i);
+    markActive(x, y);
+    ++version;
+}
+
+void Ocean::Impl::fill(int algaeCount, int herbivoreCount, int predatorCount, const std::vector<float>* density) {
+    if (algaeCount < 0 || herbivoreCount < 0 || predatorCount < 0) {
+        throw std::invalid_argument("Ocean::randomFill: Counts must be non-negative.");
+    }
+    long long total = static_cast<long long>(algaeCount) + herbivoreCount + predatorCount;
+    long long freeCells = counts[static_cast<std::size_t>(EntityType::Sand)];
+    if (total > freeCells) {
+        throw std::invalid_argument("Ocean::randomFill: " + std::to_string(total) + " entities do not fit into " +
+                                    std::to_string(freeCells) + " free cells.");
+    }
+    // i-е по счёту существо: сначала водоросли, затем травоядные, затем хищники.
+    auto typeOf = [&](long long i) {
+        return i < algaeCount ? EntityType::Algae
+             : i < algaeCount + herbivoreCount ? EntityType::HerbivoreFish : EntityType::PredatorFish;
+    };
+    const int width = front.width;
+    const int height = front.height;
+
+    // Отдельный поток чисел, не пересекающийся с номерами ячеек. Номер потока
+    // сдвигается, только когда поле действительно заполняется.
+    CounterRandom gen(CounterRandom::key(seed, static_cast<std::uint64_t>(tickCount)), FILL_STREAM - fillCount);
+
+    if (density != nullptr) {
+        // Выборка без возвращения с весами (Эфраимидис — Спиракис): у клетки
+        // ключ -ln(u) / w, берутся total наименьших ключей.
+        std::vector<std::pair<double, std::size_t>> keys;
+        std::vector<EntityType> scratch;
+        for (int y = 0; y < height; ++y) {
+            const EntityType* row = front.row(y, scratch);
+            const float* weights = density->data() + static_cast<std::size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                float weight = weights[x];
+                if (!(weight >= 0) || weight == std::numeric_limits<float>::infinity()) {
+                    throw std::invalid_argument("Ocean::randomFill: Density weights must be finite and non-negative.");
+                }
+                if (weight > 0 && row[x] == EntityType::Sand) {
+                    double u = (static_cast<double>(gen() >> 11) + 0.5) * 0x1p-53;
+                    keys.emplace_back(-std::log(u) / weight, static_cast<std::size_t>(y) * width + x);
+                }
             }
+        }
+        if (total > static_cast<long long>(keys.size())) {
+            throw std::invalid_argument("Ocean::randomFill: " + std::to_string(total) + " entities do not fit into " +
+                                        std::to_string(keys.size()) + " free cells with positive density.");
+        }
+        ++fillCount;
+        std::nth_element(keys.begin(), keys.begin() + total, keys.end());
+        // Порядок отобранных клеток зависит от веса, поэтому виды раздаются после перемешивания.
+        for (long long i = 0; i < total; ++i) {
+            std::size_t j = static_cast<std::size_t>(i) + gen.below(static_cast<std::uint32_t>(total - i));
+            std::swap(keys[static_cast<std::size_t>(i)], keys[j]);
+            std::size_t cell = keys[static_cast<std::size_t>(i)].second;
+            place(static_cast<int>(cell % width), static_cast<int>(cell / width), typeOf(i));
+        }
+        return;
+    }
 
-            if (entity) {
-                entity->tick(x, y, *this, nextOcean);
+    ++fillCount;
+    long long cells = static_cast<long long>(width) * height;
+    if ((freeCells - total) * 4 >= cells * 3 || freeCells > std::numeric_limits<std::uint32_t>::max()) {
+        // Проба берёт любую клетку поля, в том числе занятую. Пока и после
+        // заполнения свободно не меньше трёх четвертей поля, проба удаётся
+        // с вероятностью от 3/4, на существо уходит меньше 1.34 попытки,
+        // и пробы дешевле прохода по всему полю. Поля больше 2^32 клеток тоже идут сюда.
+        for (long long i = 0; i < total;) {
+            int y = static_cast<int>(gen.below(static_cast<std::uint32_t>(height)));
+            int x = static_cast<int>(gen.below(static_cast<std::uint32_t>(width)));
+            if (front.cellAt(x, y) == EntityType::Sand) {
+                place(x, y, typeOf(i++));
             }
         }
+        return;
     }
-    *this = std::move(nextOcean);
-}
 
-void Ocean::randomFill(int algaeCount, int herbivoreCount, int predatorCount) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distX(0, getWidth() - 1);
-    std::uniform_int_distribution<int> distY(0, getHeight() - 1);
-
-    auto placeEntities = [&](int count, EntityType type) {
-        for (int i = 0; i < count;) {
-            int x = distX(gen);
-            int y = distY(gen);
-            if (getCellType(x, y) == EntityType::Sand) {
-                setCell(x, y, type);
-                i++;
+    // Плотное заполнение: один проход по полю по порядку. Свободная клетка
+    // получает вид с вероятностью (осталось поставить этого вида) / (осталось
+    // свободных клеток), так что все расстановки ровно total существ равновероятны,
+    // а память читается подряд, а не вразброс.
+    long long remaining[3] = {algaeCount, herbivoreCount, predatorCount};
+    const EntityType types[3] = {EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish};
+    std::uint32_t left = static_cast<std::uint32_t>(freeCells);
+    std::vector<EntityType> scratch;
+    for (int y = 0; y < height && total > 0; ++y) {
+        const EntityType* row = front.row(y, scratch);
+        for (int x = 0; x < width && total > 0; ++x) {
+            if (row[x] != EntityType::Sand) {
+                continue;
+            }
+            long long roll = gen.below(left--);
+            for (int k = 0; k < 3; ++k) {
+                if (roll < remaining[k]) {
+                    --remaining[k];
+                    --total;
+                    place(x, y, types[k]);
+                    break;
+                }
+                roll -= remaining[k];
             }
         }
+    }
+}
+
+int Ocean::countEntities(EntityType type) const {
+    if (static_cast<std::size_t>(type) >= pimpl->counts.size()) {
+        return 0;
+    }
+    return static_cast<int>(pimpl->counts[static_cast<std::size_t>(type)]);
+}
+
+EntityCounts Ocean::countAllEntities() const {
+    return pimpl->counts;
+}
+
+void Ocean::copyRow(int y, EntityType* out) const {
+    const Buffer& grid = pimpl->front;
+    if (y < 0 || y >= grid.height) {
+        throw std::out_of_range("Ocean::copyRow: Row out of bounds");
+    }
+    grid.copyRow(y, out);
+}
+
+void Ocean::captureFrame(OceanFrame& frame) const {
+    const Buffer& grid = pimpl->front;
+    frame.width = grid.width;
+    frame.height = grid.height;
+    frame.tick = pimpl->tickCount;
+    frame.counts = pimpl->counts;
+    frame.cells.resize(static_cast<std::size_t>(grid.width) * grid.height);
+    for (int y = 0; y < grid.height; ++y) {
+        grid.copyRow(y, frame.cells.data() + static_cast<std::size_t>(y) * grid.width);
+    }
+}
+
+
+void Ocean::Impl::refreshSummedArea() {
+    if (summedArea.getWidth() != front.width || summedArea.getHeight() != front.height) {
+        summedArea.resize(front.width, front.height);
+    }
+    // Строки считаются полосами по ROW_BAND, столбцы — полосами по COLUMN_BAND.
+    constexpr int ROW_BAND = 64;
+    constexpr int COLUMN_BAND = 256;
+    std::size_t rowBands = static_cast<std::size_t>((front.height + ROW_BAND - 1) / ROW_BAND);
+    std::size_t columnBands = static_cast<std::size_t>((front.width + COLUMN_BAND - 1) / COLUMN_BAND);
+    auto sumRows = [&](std::size_t band, int) {
+        int end = std::min(front.height, static_cast<int>(band + 1) * ROW_BAND);
+        std::vector<EntityType> scratch;
+        for (int y = static_cast<int>(band) * ROW_BAND; y < end; ++y) {
+            summedArea.sumRow(y, front.row(y, scratch));
+        }
+    };
+    auto sumColumns = [&](std::size_t band, int) {
+        int x0 = static_cast<int>(band) * COLUMN_BAND;
+        summedArea.accumulateColumns(x0, x0 + COLUMN_BAND);
     };
+    if (pool) {
+        pool->parallelFor(rowBands, sumRows);
+        pool->parallelFor(columnBands, sumColumns);
+    } else {
+        // В одном потоке строка сразу прибавляется к предыдущей, пока та в кэше.
+        std::vector<EntityType> scratch;
+        for (int y = 0; y < front.height; ++y) {
+            summedArea.addRow(y, front.row(y, scratch));
+        }
+    }
+    summedVersion.store(version, std::memory_order_release);
+}
 
-    placeEntities(algaeCount, EntityType::Algae);
-    placeEntities(herbivoreCount, EntityType::HerbivoreFish);
-    placeEntities(predatorCount, EntityType::PredatorFish);
+const SummedAreaTable& Ocean::getSummedArea() const {
+    Impl& impl = *pimpl;
+    if (impl.summedVersion.load(std::memory_order_acquire) != impl.version) {
+        std::lock_guard<std::mutex> lock(impl.summedMutex);
+        if (impl.summedVersion.load(std::memory_order_relaxed) != impl.version) {
+            impl.refreshSummedArea();
+        }
+    }
+    return impl.summedArea;
 }
 
-int Ocean::countEntities(EntityType type) const {
-    int count = 0;
-    for (int x = 0; x < getWidth(); ++x) {
-        for (int y = 0; y < getHeight(); ++y) {
-            if (getCellType(x, y) == type) { 
-                count++;
+long long Ocean::countInRect(EntityType type, int x, int y, int width, int height) const {
+    return getSummedArea().count(type, x, y, width, height);
+}
+
+void Ocean::setSummedAreaTracking(bool enabled) {
+    pimpl->trackSummedArea = enabled;
+    if (!enabled) {
+        // Таблица больше не обновляется тактом, память можно отдать.
+        pimpl->summedArea = SummedAreaTable();
+        pimpl->summedVersion = ~0ULL;
+    }
+}
+
+bool Ocean::getSummedAreaTracking() const {
+    return pimpl->trackSummedArea;
+}
+
+void Ocean::buildHeatmap(int block, Heatmap& out) const {
+    if (pimpl->trackSummedArea) {
+        getSummedArea().heatmap(block, out);
+        return;
+    }
+    const Buffer& grid = pimpl->front;
+    out.resize(grid.width, grid.height, block);
+    std::vector<EntityType> scratch;
+    for (int y = 0; y < grid.height; ++y) {
+        const EntityType* row = grid.row(y, scratch);
+        std::size_t base = static_cast<std::size_t>(y / block) * out.blocksX;
+        for (int bx = 0; bx < out.blocksX; ++bx) {
+            int end = std::min(grid.width, (bx + 1) * block);
+            for (int x = bx * block; x < end; ++x) {
+                ++out.counts[static_cast<std::size_t>(row[x])][base + bx];
             }
         }
     }
-    return count;
 }
+
+void Ocean::packPlanes(BitPlanes& planes) const {
+    const Buffer& grid = pimpl->front;
+    if (planes.getWidth() != grid.width || planes.getHeight() != grid.height) {
+        planes.resize(grid.width, grid.height);
+    }
+    std::vector<EntityType> scratch;
+    for (int y = 0; y < grid.height; ++y) {
+        planes.packRow(y, grid.row(y, scratch));
+    }
+}
\ No newline at end of file
@@ -3,14 +3,40 @@
 
 #include "IWritableOcean.h"
 #include "EntityType.h" // Убедитесь, что этот файл существует и содержит enum class EntityType
+#include "ThreadPool.h"
+#include "TickStats.h"
+#include "BitPlanes.h"
+#include "Boundary.h"
+#include "CellArray.h"
+#include "GridLayout.h"
+#include "Intent.h"
+#include "SpeciesParams.h"
+#include "SummedAreaTable.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <stdexcept>
-#include <random>
+
+// Снимок состояния для отображения: типы клеток построчно и численность видов.
+struct OceanFrame {
+    int width = 0;
+    int height = 0;
+    long long tick = 0;
+    EntityCounts counts{};
+    std::vector<EntityType> cells;
+};
 
 class Ocean : public IWritableOcean {
 public:
-    Ocean(int width, int height);
+    // Для Boundary::Torus и Boundary::Reflect обе стороны должны быть не меньше 3.
+    // layout задаёт только порядок ячеек в памяти, см. GridLayout.
+    Ocean(int width, int height, std::uint64_t seed = 0, Boundary boundary = Boundary::Walls,
+          GridLayout layout = GridLayout::Linear);
     ~Ocean() override;
     Ocean(const Ocean& other);
     Ocean(Ocean&& other) noexcept;
@@ -18,35 +44,345 @@ public:
     Ocean& operator=(Ocean&& other) noexcept;
 
     EntityType getCellType(int x, int y) const override;
+    int getAge(int x, int y) const override;
+    int getHunger(int x, int y) const override;
     bool inBounds(int x, int y) const override;
     int getWidth() const override;
     int getHeight() const override;
+    Boundary getBoundary() const;
+    GridLayout getLayout() const;
 
     void setCell(int x, int y, EntityType type) override;
+    void setCell(int x, int y, EntityType type, int age, int hunger) override;
 
+    // Такт в два этапа: сначала каждое существо по текущему полю заявляет, куда
+    // хочет пойти, съесть или отложить потомка, затем спорные клетки достаются
+    // заявке с наибольшим хешем (seed, номер такта, клетка). Хищники выбирают
+    // добычу раньше травоядных, травоядные — раньше, чем кто-то занимает песок.
+    // Исход не зависит ни от порядка обхода, ни от числа потоков.
     void tick();
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+    std::uint64_t getSeed() const;
+    long long getTickCount() const;
+
+    // Ставит ровно столько существ в случайные клетки с песком. Если существ
+    // больше, чем свободных клеток, бросает std::invalid_argument и не меняет поле.
     void randomFill(int algaeCount, int herbivoreCount, int predatorCount);
+    // То же, но клетка выбирается с вероятностью, пропорциональной density
+    // (getWidth() * getHeight() неотрицательных весов построчно, см. Seeding.h);
+    // клетки с нулевым весом остаются пустыми.
+    void randomFill(int algaeCount, int herbivoreCount, int predatorCount, const std::vector<float>& density);
+
+    // Численность вида (или всех видов сразу) в текущем состоянии. Счётчики
+    // поддерживаются при каждой записи, поэтому оба вызова стоят O(1).
+    int countEntities(EntityType type) const;
+    EntityCounts countAllEntities() const;
+
+    // Копирует строку y текущего состояния (getWidth() значений) в out.
+    void copyRow(int y, EntityType* out) const;
+    // Повторно использует память кадра, если размер поля не менялся.
+    void captureFrame(OceanFrame& frame) const;
+
+    // Счётчики событий и время фаз с момента создания или resetStats.
+    // Собираются только при сборке с OCEAN_STATS (см. STATS_ENABLED), иначе нули.
+    const TickStats& getStats() const;
+    void resetStats();
+    // Параметры видов действуют со следующего такта. Пока они совпадают
+    // с умолчаниями, такт идёт по ядрам со встроенными константами.
+    void setSpeciesParams(const EcosystemParams& params);
+    const EcosystemParams& getSpeciesParams() const;
+    // Упаковывает текущее состояние по битовым плоскостям для анализа; для
+    // подсчёта соседей всех клеток сразу см. countNeighbours в BitPlanes.h.
+    // Сам такт плоскостями не пользуется.
+    void packPlanes(BitPlanes& planes) const;
 
-    // ИСПРАВЛЕНИЕ: Теперь countEntities принимает EntityType как обычный аргумент
-    int countEntities(EntityType type) const; 
+    // Таблица сумм текущего состояния: численность вида в любом прямоугольнике
+    // за O(1). Первое обращение после изменения поля перестраивает её за O(W*H)
+    // под мьютексом, поэтому константные запросы можно делать из нескольких
+    // потоков сразу (но не одновременно с изменением поля). С
+    // setSummedAreaTracking(true) таблицу перестраивает сам tick() потоками пула.
+    const SummedAreaTable& getSummedArea() const;
+    long long countInRect(EntityType type, int x, int y, int width, int height) const;
+    void setSummedAreaTracking(bool enabled);
+    bool getSummedAreaTracking() const;
+    // Численность видов по блокам block x block: из таблицы сумм, если она
+    // отслеживается, иначе одним проходом по полю.
+    void buildHeatmap(int block, Heatmap& out) const;
+
+    // Двоичный снимок состояния: поле, возраст и голод, номер такта и состояние
+    // генератора. Продолжение с загруженного снимка даёт те же результаты, что и
+    // непрерывный прогон. Ошибки чтения и записи — std::runtime_error.
+    // Загрузка проверяет заголовок, рамку и список плиток, а сами клетки —
+    // только с verifyCells: этот проход стоит O(W*H).
+    void saveSnapshot(const std::string& path) const;
+    static Ocean loadSnapshot(const std::string& path, bool verifyCells = false);
 
 private:
-    class Impl : public IWritableOcean {
+    // Плитка — единица планирования: пустые плитки такт пропускает, а заявки
+    // существ через край плитки разбирает плитка, в которую они целят. В блочных
+    // раскладках блок хранения тоже TILE_SIZE x TILE_SIZE.
+    static constexpr int TILE_SIZE = 64;
+
+    // Разбиение поля на плитки по TILE_SIZE, последние в ряду могут быть уже,
+    // но не уже двух клеток: заявка малька, который бывает в двух клетках от
+    // родителя, не перескакивает через плитку.
+    // first — ширина первой плитки: в блочных раскладках TILE_SIZE - 1, потому
+    // что первый блок хранения начинается с рамки, и плитка совпадает с блоком.
+    struct TileGrid {
+        int tilesX = 0;
+        int tilesY = 0;
+        std::vector<int> columnStart;   // tilesX + 1 границ
+        std::vector<int> rowStart;      // tilesY + 1 границ
+        std::vector<int> columnOf;      // номер столбца плиток для каждого x
+        std::vector<int> rowOf;
+
+        TileGrid(int width, int height, int first = TILE_SIZE);
+        int tileOf(int x, int y) const { return rowOf[y] * tilesX + columnOf[x]; }
+        int count() const { return tilesX * tilesY; }
+
+        // Границы плиток вдоль одной оси и номер плитки для каждой координаты.
+        static void splitAxis(int size, int first, std::vector<int>& start, std::vector<int>& tileOf);
+    };
+
+    // Множество номеров плиток: флаг на каждую плитку и список отмеченных.
+    struct TileSet {
+        std::vector<std::uint8_t> flags;
+        std::vector<int> tiles;
+
+        void insert(int tile) {
+            if (!flags[tile]) {
+                flags[tile] = 1;
+                tiles.push_back(tile);
+            }
+        }
+        void clear() {
+            for (int tile : tiles) flags[tile] = 0;
+            tiles.clear();
+        }
+    };
+
+    // Индексы ячеек, в которых задний буфер может отличаться от переднего.
+    // Если изменений слишком много, проще скопировать буфер целиком.
+    struct ChangeLog {
+        std::vector<std::size_t> indices;
+        std::size_t limit = 0;
+        bool overflow = false;
+
+        void note(std::size_t i) {
+            if (overflow) return;
+            if (indices.size() < limit) indices.push_back(i);
+            else overflow = true;
+        }
+    };
+
+    class Buffer : public IWritableOcean {
     public:
-        Impl(int width, int height);
-        Impl(const Impl& other);
+        // При allocate == false массивы остаются пустыми и заполняются снаружи.
+        Buffer(int width, int height, ChangeLog* log, GridLayout layout = GridLayout::Linear, bool allocate = true);
+        Buffer(const Buffer& other, ChangeLog* log);
 
         EntityType getCellType(int x, int y) const override;
+        int getAge(int x, int y) const override;
+        int getHunger(int x, int y) const override;
         void setCell(int x, int y, EntityType type) override;
+        void setCell(int x, int y, EntityType type, int age, int hunger) override;
         bool inBounds(int x, int y) const override;
         int getWidth() const override;
         int getHeight() const override;
 
-        std::vector<std::vector<EntityType>> grid;
+        // Вокруг поля — рамка из BORDER_CELL, поэтому соседей (x +- 1, y +- 1)
+        // можно читать без проверки границ. В блочных раскладках индекс — сумма
+        // смещений строки и столбца из таблиц. Горячие циклы такта выбирают
+        // раскладку при компиляции через indexIn, остальной код — через index.
+        template <bool Linear>
+        std::size_t indexIn(int x, int y) const {
+            if constexpr (Linear) {
+                return static_cast<std::size_t>(y + 1) * stride + static_cast<std::size_t>(x + 1);
+            } else {
+                return rowBase[y + 1] + columnBase[x + 1];
+            }
+        }
+        std::size_t index(int x, int y) const {
+            return layout == GridLayout::Linear ? indexIn<true>(x, y) : indexIn<false>(x, y);
+        }
+        // Строка y подряд: в построчной раскладке — сами ячейки, иначе копия в scratch.
+        const EntityType* row(int y, std::vector<EntityType>& scratch) const;
+        void copyRow(int y, EntityType* out) const;
+
+        // Доступ без виртуальных вызовов и проверок для EntityKernel.
+        EntityType cellAt(int x, int y) const { return cells[index(x, y)]; }
+        int ageAt(int x, int y) const { return age[index(x, y)]; }
+        int hungerAt(int x, int y) const { return hunger[index(x, y)]; }
+        void store(std::size_t i, EntityType type, int age, int hunger) {
+            cells[i] = type;
+            this->age[i] = static_cast<std::uint16_t>(age);
+            this->hunger[i] = static_cast<std::uint16_t>(hunger);
+        }
+
+        void swapContents(Buffer& other);
+
         int width;
         int height;
+        GridLayout layout;
+        std::size_t stride;
+        // Ячеек в массивах: поле с рамкой, в блочных раскладках — целые блоки.
+        std::size_t cellCount;
+        std::vector<std::size_t> rowBase;       // height + 2 смещений, с рамкой
+        std::vector<std::size_t> columnBase;    // width + 2
+        // Состояние существ хранится параллельными массивами с тем же индексом,
+        // что и тип ячейки, и переезжает вместе с существом.
+        CellArray<EntityType> cells;
+        CellArray<std::uint16_t> age;
+        CellArray<std::uint16_t> hunger;
+        ChangeLog* log;
+    };
+
+    // Чтение буфера для EntityKernel с раскладкой, известной при компиляции.
+    template <bool Linear>
+    struct BufferView {
+        const Buffer& buffer;
+
+        EntityType cellAt(int x, int y) const { return buffer.cells[buffer.indexIn<Linear>(x, y)]; }
+        int ageAt(int x, int y) const { return buffer.age[buffer.indexIn<Linear>(x, y)]; }
+        int hungerAt(int x, int y) const { return buffer.hunger[buffer.indexIn<Linear>(x, y)]; }
+    };
+
+    // Данные, которые поток накапливает за такт без синхронизации.
+    // Выравнивание по строке кэша разводит счётчики разных потоков.
+    struct alignas(64) WorkerState {
+        ChangeLog log;
+        EntityCounts delta{};
+        TileSet touched;    // плитки, куда записано существо
+        TileSet claimed;    // чужие плитки, куда целят заявки из своих плиток
+        TickStats stats;
+    };
+
+    // Запись в задний буфер из одного потока.
+    class Writer {
+    public:
+        Writer(Buffer& buffer, WorkerState& worker, const TileGrid& tiles)
+            : buffer(buffer), worker(worker), tiles(tiles) {}
+
+        EntityType cellAt(int x, int y) const { return buffer.cellAt(x, y); }
+        void put(int x, int y, EntityType type, int age = 0, int hunger = 0) {
+            std::size_t i = buffer.index(x, y);
+            --worker.delta[static_cast<std::size_t>(buffer.cells[i])];
+            ++worker.delta[static_cast<std::size_t>(type)];
+            buffer.store(i, type, age, hunger);
+            worker.log.note(i);
+            if (type != EntityType::Sand) {
+                worker.touched.insert(tiles.tileOf(x, y));
+            }
+        }
+        void noteEvent(TickEvent event, EntityType species) { worker.stats.note(event, species); }
+
+    private:
+        Buffer& buffer;
+        WorkerState& worker;
+        const TileGrid& tiles;
+    };
+
+    // Передний буфер — текущее состояние, задний — следующий такт.
+    // После такта буферы меняются местами, новая память не выделяется.
+    class Impl {
+    public:
+        static constexpr std::uint64_t FILL_STREAM = ~0ULL;
+
+        Impl(int width, int height, std::uint64_t seed, Boundary boundary,
+             GridLayout layout = GridLayout::Linear, bool allocate = true);
+        // Полоса раздела: rows строк поля со стенами, начиная со строки rowOffset.
+        Impl(int width, int rows, int rowOffset, std::uint64_t seed);
+        Impl(const Impl& other);
+
+        void setThreadCount(int threadCount);
+        void syncBack();
+        template <class Fn>
+        void forTiles(const std::vector<int>& list, Fn fn);
+        // Такт в два этапа. propose читает только передний буфер и пишет
+        // намерения существ плитки; claimTile выставляет в claims победителя
+        // за каждую клетку плитки; applyTile пишет исход в задний буфер.
+        void proposeTile(int tile, WorkerState& worker);
+        template <class View>
+        void proposeIn(int tile, const View& cells, WorkerState& worker);
+        template <class View, class Current>
+        void proposeWith(int tile, const View& cells, const Current& current, WorkerState& worker);
+        template <class Rules, class View, class Current>
+        void proposeCells(int tile, const View& cells, const Current& current, WorkerState& worker,
+                          const Rules& rules);
+        // Раунды разбора: хищники выбирают добычу раньше травоядных, а они —
+        // раньше, чем кто-то занимает песок. Добычу хищник получает, только
+        // если опережает её по приоритету, иначе она успевает сделать свой ход.
+        enum class ClaimRound { PredatorsEat, HerbivoresEat, Free };
+        static constexpr int CLAIM_ROUNDS = 3;
+        static ClaimRound roundOf(const Intent& intent);
+        void claimTile(int tile, ClaimRound round);
+        void applyTile(int tile, WorkerState& worker);
+        void clearTile(int tile);
+        // Заявки раунда, которые целят в клетки плитки: свои и из соседних плиток.
+        template <class Fn>
+        void forEachIncoming(int tile, ClaimRound round, Fn fn) const;
+        // Переводит цель заявки в поле по границе и ставит код и приоритет заявки.
+        void aim(Intent& intent) const;
+        bool outranks(const Intent& intent, std::size_t cell) const;
+        bool catches(const Intent& intent) const;
+        std::uint32_t priorityAt(int x, int y) const;
+        void collectWorkers();
+        void markActive(int x, int y);
+        void fill(int algaeCount, int herbivoreCount, int predatorCount, const std::vector<float>* density);
+        void place(int x, int y, EntityType type);
+        void refreshSummedArea();
+
+        Boundary boundary;
+        TileGrid tiles;
+        std::vector<WorkerState> workers;
+        EntityCounts counts{};
+        Buffer front;
+        Buffer back;
+        // Такт обходит только плитки, где есть существа; пустые области ничего не стоят.
+        TileSet active;
+        // Плитки, считаемые в этом такте, и плитки, куда целят их заявки.
+        TileSet proposed;
+        TileSet resolving;
+        // Намерения существ плитки (у рыбы, готовой к размножению, следом идёт
+        // заявка на клетку малька) и номера заявок по раундам: inside целят
+        // в свою плитку, crossing — в соседнюю.
+        struct TileIntents {
+            std::vector<Intent> intents;
+            std::vector<std::uint32_t> inside[CLAIM_ROUNDS];
+            std::vector<std::uint32_t> crossing[CLAIM_ROUNDS];
+        };
+        std::vector<TileIntents> intents;
+        // Код победившей заявки на клетку (0 — заявок нет) и её приоритет,
+        // индексы как у Buffer. claims заводится при первом такте и после такта
+        // снова обнулён; приоритет читается, только пока код не 0.
+        std::vector<std::uint8_t> claims;
+        std::vector<std::uint32_t> claimPriorities;
+        std::unique_ptr<ThreadPool> pool;
+        std::uint64_t seed;
+        long long tickCount = 0;
+        std::uint64_t tickKey = 0;      // ключ генераторов текущего такта
+        std::uint64_t fillCount = 0;
+        EcosystemParams params;
+        bool customParams = false;
+        // version растёт при каждом изменении поля; таблица сумм актуальна,
+        // пока summedVersion с ним совпадает. summedVersion читается без
+        // блокировки, а перестраивает таблицу тот, кто захватил summedMutex.
+        std::uint64_t version = 0;
+        std::atomic<std::uint64_t> summedVersion{~0ULL};
+        std::mutex summedMutex;
+        bool trackSummedArea = false;
+        SummedAreaTable summedArea;
+        TickStats stats;
+        // Раздел хранит строки поля начиная с rowOffset: от неё зависят номера
+        // потоков генератора и приоритеты заявок.
+        int rowOffset = 0;
     };
 
+    friend class OceanPartition;
+
+    explicit Ocean(std::unique_ptr<Impl> impl);
+
     std::unique_ptr<Impl> pimpl;
 };
 
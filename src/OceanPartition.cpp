@@ -0,0 +1,248 @@
+#include "OceanPartition.h"
+#include "CounterRandom.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+using Side = HaloTransport::Side;
+
+// Клетка в сообщении: тип, затем возраст и голод от младшего байта к старшему.
+constexpr std::size_t CELL_BYTES = 5;
+
+void packCounts(const EntityCounts& counts, std::vector<std::uint8_t>& message) {
+    message.clear();
+    for (long long count : counts) {
+        for (int i = 0; i < 8; ++i) {
+            message.push_back(static_cast<std::uint8_t>(static_cast<std::uint64_t>(count) >> (8 * i)));
+        }
+    }
+}
+
+EntityCounts unpackCounts(const std::vector<std::uint8_t>& message) {
+    EntityCounts counts{};
+    if (message.size() != counts.size() * 8) {
+        throw std::runtime_error("OceanPartition: Malformed count message");
+    }
+    for (std::size_t type = 0; type < counts.size(); ++type) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<std::uint64_t>(message[type * 8 + i]) << (8 * i);
+        }
+        counts[type] = static_cast<long long>(value);
+    }
+    return counts;
+}
+
+}
+
+std::pair<int, int> OceanPartition::ownedRows(int height, int rank, int ranks) {
+    if (height <= 0 || ranks <= 0 || rank < 0 || rank >= ranks) {
+        throw std::invalid_argument("OceanPartition: Height must be positive and rank within [0, ranks).");
+    }
+    if (height < static_cast<long long>(ranks) * HALO) {
+        throw std::invalid_argument("OceanPartition: " + std::to_string(ranks) + " ranks need a grid of at least " +
+                                    std::to_string(static_cast<long long>(ranks) * HALO) + " rows.");
+    }
+    long long first = static_cast<long long>(rank) * height / ranks;
+    long long last = static_cast<long long>(rank + 1) * height / ranks;
+    return {static_cast<int>(first), static_cast<int>(last)};
+}
+
+Ocean OceanPartition::makeOcean(int width, int storedBegin, int storedEnd, std::uint64_t seed) {
+    if (width <= 0) {
+        throw std::invalid_argument("OceanPartition: Width must be positive.");
+    }
+    return Ocean(std::make_unique<Ocean::Impl>(width, storedEnd - storedBegin, storedBegin, seed));
+}
+
+OceanPartition::OceanPartition(int width, int height, int rank, int ranks, HaloTransport& transport, std::uint64_t seed)
+    : width(width), height(height), rank(rank), ranks(ranks),
+      rowBegin(ownedRows(height, rank, ranks).first), rowEnd(ownedRows(height, rank, ranks).second),
+      storedBegin(std::max(rowBegin - HALO, 0)), storedEnd(std::min(rowEnd + HALO, height)),
+      transport(transport), ocean(makeOcean(width, storedBegin, storedEnd, seed)) {
+    if (transport.hasNeighbour(Side::Above) != (rank > 0) ||
+        transport.hasNeighbour(Side::Below) != (rank + 1 < ranks)) {
+        throw std::invalid_argument("OceanPartition: Transport neighbours do not match the rank.");
+    }
+}
+
+EntityType OceanPartition::getCellType(int x, int y) const {
+    return ocean.getCellType(x, y - storedBegin);
+}
+
+int OceanPartition::getAge(int x, int y) const {
+    return ocean.getAge(x, y - storedBegin);
+}
+
+int OceanPartition::getHunger(int x, int y) const {
+    return ocean.getHunger(x, y - storedBegin);
+}
+
+void OceanPartition::copyRow(int y, EntityType* out) const {
+    ocean.copyRow(y - storedBegin, out);
+}
+
+void OceanPartition::setCell(int x, int y, EntityType type, int age, int hunger) {
+    if (!owns(x, y)) {
+        throw std::out_of_range("OceanPartition::setCell: Cell belongs to another partition");
+    }
+    ocean.setCell(x, y - storedBegin, type, age, hunger);
+}
+
+void OceanPartition::packRows(const Ocean::Buffer& source, int y0, int y1, std::vector<std::uint8_t>& message) const {
+    message.resize(static_cast<std::size_t>(y1 - y0) * width * CELL_BYTES);
+    std::uint8_t* out = message.data();
+    for (int y = y0; y < y1; ++y) {
+        for (int x = 0; x < width; ++x, out += CELL_BYTES) {
+            std::size_t i = source.index(x, y - storedBegin);
+            out[0] = static_cast<std::uint8_t>(source.cells[i]);
+            out[1] = static_cast<std::uint8_t>(source.age[i]);
+            out[2] = static_cast<std::uint8_t>(source.age[i] >> 8);
+            out[3] = static_cast<std::uint8_t>(source.hunger[i]);
+            out[4] = static_cast<std::uint8_t>(source.hunger[i] >> 8);
+        }
+    }
+}
+
+void OceanPartition::applyRows(Ocean::Buffer& target, int y0, int y1, const std::vector<std::uint8_t>& message) {
+    if (message.size() != static_cast<std::size_t>(y1 - y0) * width * CELL_BYTES) {
+        throw std::runtime_error("OceanPartition: Halo message has a wrong size");
+    }
+    Ocean::Impl& impl = *ocean.pimpl;
+    const std::uint8_t* in = message.data();
+    for (int y = y0; y < y1; ++y) {
+        for (int x = 0; x < width; ++x, in += CELL_BYTES) {
+            std::size_t i = target.index(x, y - storedBegin);
+            if (in[0] > static_cast<std::uint8_t>(EntityType::PredatorFish)) {
+                throw std::runtime_error("OceanPartition: Halo message has an unknown cell type");
+            }
+            EntityType type = static_cast<EntityType>(in[0]);
+            int age = in[1] | in[2] << 8;
+            int hunger = in[3] | in[4] << 8;
+            if (target.cells[i] != type || target.age[i] != age || target.hunger[i] != hunger) {
+                --impl.counts[static_cast<std::size_t>(target.cells[i])];
+                ++impl.counts[static_cast<std::size_t>(type)];
+                target.store(i, type, age, hunger);
+                target.log->note(i);
+            }
+            // Копии соседа тоже считаются в следующем такте.
+            if (type != EntityType::Sand) {
+                impl.markActive(x, y - storedBegin);
+            }
+        }
+    }
+    ++impl.version;
+}
+
+void OceanPartition::syncHalo() {
+    Ocean::Impl& impl = *ocean.pimpl;
+    // Сначала вниз по всей цепочке, затем вверх: последний раздел только
+    // принимает, и ни одна отправка не ждёт встречной.
+    if (transport.hasNeighbour(Side::Below)) {
+        packRows(impl.front, std::max(rowEnd - HALO, rowBegin), rowEnd, outgoing);
+        transport.send(Side::Below, outgoing);
+    }
+    if (transport.hasNeighbour(Side::Above)) {
+        transport.receive(Side::Above, incoming);
+        applyRows(impl.front, std::max(rowBegin - HALO, 0), rowBegin, incoming);
+        packRows(impl.front, rowBegin, std::min(rowBegin + HALO, rowEnd), outgoing);
+        transport.send(Side::Above, outgoing);
+    }
+    if (transport.hasNeighbour(Side::Below)) {
+        transport.receive(Side::Below, incoming);
+        applyRows(impl.front, rowEnd, std::min(rowEnd + HALO, height), incoming);
+    }
+}
+
+void OceanPartition::randomFill(double algae, double herbivores, double predators) {
+    if (!(algae >= 0 && herbivores >= 0 && predators >= 0 && algae + herbivores + predators <= 1)) {
+        throw std::invalid_argument("OceanPartition::randomFill: Fractions must be non-negative and sum to at most 1.");
+    }
+    Ocean::Impl& impl = *ocean.pimpl;
+    std::uint64_t key = CounterRandom::key(impl.seed, Ocean::Impl::FILL_STREAM - impl.fillCount);
+    ++impl.fillCount;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (impl.front.cellAt(x, y - storedBegin) != EntityType::Sand) {
+                continue;
+            }
+            CounterRandom gen(key, static_cast<std::uint64_t>(y) * width + x);
+            double u = static_cast<double>(gen() >> 11) * 0x1.0p-53;
+            if (u < algae) {
+                impl.place(x, y - storedBegin, EntityType::Algae);
+            } else if (u < algae + herbivores) {
+                impl.place(x, y - storedBegin, EntityType::HerbivoreFish);
+            } else if (u < algae + herbivores + predators) {
+                impl.place(x, y - storedBegin, EntityType::PredatorFish);
+            }
+        }
+    }
+    syncHalo();
+}
+
+void OceanPartition::tick() {
+    ocean.tick();
+    syncHalo();
+}
+
+void OceanPartition::setThreadCount(int threadCount) {
+    ocean.setThreadCount(threadCount);
+}
+
+int OceanPartition::getThreadCount() const {
+    return ocean.getThreadCount();
+}
+
+void OceanPartition::setSpeciesParams(const EcosystemParams& params) {
+    ocean.setSpeciesParams(params);
+}
+
+std::uint64_t OceanPartition::getSeed() const {
+    return ocean.getSeed();
+}
+
+long long OceanPartition::getTickCount() const {
+    return ocean.getTickCount();
+}
+
+EntityCounts OceanPartition::countOwned() const {
+    EntityCounts counts = ocean.countAllEntities();
+    const Ocean::Buffer& front = ocean.pimpl->front;
+    std::vector<EntityType> scratch;
+    auto subtractRows = [&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y) {
+            const EntityType* row = front.row(y - storedBegin, scratch);
+            for (int x = 0; x < width; ++x) {
+                --counts[static_cast<std::size_t>(row[x])];
+            }
+        }
+    };
+    subtractRows(storedBegin, rowBegin);
+    subtractRows(rowEnd, storedEnd);
+    return counts;
+}
+
+EntityCounts OceanPartition::countAll() {
+    // Частичные суммы идут вниз по цепочке, итог — обратно вверх.
+    EntityCounts total = countOwned();
+    if (transport.hasNeighbour(Side::Above)) {
+        transport.receive(Side::Above, incoming);
+        EntityCounts above = unpackCounts(incoming);
+        for (std::size_t type = 0; type < total.size(); ++type) {
+            total[type] += above[type];
+        }
+    }
+    if (transport.hasNeighbour(Side::Below)) {
+        packCounts(total, outgoing);
+        transport.send(Side::Below, outgoing);
+        transport.receive(Side::Below, incoming);
+        total = unpackCounts(incoming);
+    }
+    if (transport.hasNeighbour(Side::Above)) {
+        packCounts(total, outgoing);
+        transport.send(Side::Above, outgoing);
+    }
+    return total;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef OCEAN_PARTITION_H
+#define OCEAN_PARTITION_H
+
+#include "Ocean.h"
+#include "HaloTransport.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Одна горизонтальная полоса общего поля width x height со стенами по краям.
+// Поле делится между ranks разделами (процессами, машинами) поровну по строкам;
+// каждый раздел хранит свои строки и по HALO строк соседей с каждой стороны.
+// Такт раздел считает по всей хранимой полосе как отдельный Ocean: у краёв
+// копий результат неверен, но ошибка уходит внутрь не дальше чем на HALO строк
+// и до своих строк не доходит. После такта соседи обмениваются HALO крайними
+// своими строками, и результат совпадает с Ocean на всём поле бит в бит при
+// любом числе разделов и потоков.
+//
+// tick, syncHalo, randomFill и countAll — коллективные: их вызывают все разделы
+// в одном порядке. После ошибки связи раздел непригоден.
+class OceanPartition {
+public:
+    // Исход клетки зависит от заявок не дальше 4 клеток от неё, а заявка —
+    // от соседей заявителя; заявки мальков приходят не дальше чем из 3 клеток
+    // и зависят от клеток в двух от родителя. Итого 5 строк.
+    static constexpr int HALO = 5;
+
+    OceanPartition(int width, int height, int rank, int ranks, HaloTransport& transport, std::uint64_t seed = 0);
+    OceanPartition(const OceanPartition&) = delete;
+    OceanPartition& operator=(const OceanPartition&) = delete;
+
+    // Строки [first, second), которые достаются разделу rank; у каждого раздела
+    // не меньше HALO строк.
+    static std::pair<int, int> ownedRows(int height, int rank, int ranks);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getRank() const { return rank; }
+    int getRanks() const { return ranks; }
+    int getFirstRow() const { return rowBegin; }
+    int getRowEnd() const { return rowEnd; }
+    bool owns(int x, int y) const { return x >= 0 && x < width && y >= rowBegin && y < rowEnd; }
+
+    // Свои строки и копии строк соседей; чужие строки только для чтения.
+    EntityType getCellType(int x, int y) const;
+    int getAge(int x, int y) const;
+    int getHunger(int x, int y) const;
+    void copyRow(int y, EntityType* out) const;
+    // Только свои клетки; соседи увидят изменения после syncHalo.
+    void setCell(int x, int y, EntityType type, int age = 0, int hunger = 0);
+    void syncHalo();
+
+    // Каждая своя клетка с песком независимо становится водорослью, травоядным
+    // или хищником с данными вероятностями. Розыгрыш зависит только от seed,
+    // номера заполнения и клетки, поэтому поле не зависит от числа разделов.
+    void randomFill(double algae, double herbivores, double predators);
+
+    void tick();
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+    // Параметры должны совпадать во всех разделах.
+    void setSpeciesParams(const EcosystemParams& params);
+    std::uint64_t getSeed() const;
+    long long getTickCount() const;
+
+    // Численность в своих строках и на всём поле.
+    EntityCounts countOwned() const;
+    EntityCounts countAll();
+
+private:
+    static Ocean makeOcean(int width, int storedBegin, int storedEnd, std::uint64_t seed);
+
+    // Строки [y0, y1) буфера в сообщение и из сообщения в буфер.
+    void packRows(const Ocean::Buffer& source, int y0, int y1, std::vector<std::uint8_t>& message) const;
+    void applyRows(Ocean::Buffer& target, int y0, int y1, const std::vector<std::uint8_t>& message);
+
+    int width;
+    int height;
+    int rank;
+    int ranks;
+    int rowBegin;
+    int rowEnd;
+    // Хранимые строки: свои и копии соседей. Ocean внутри адресует их с нуля.
+    int storedBegin;
+    int storedEnd;
+    HaloTransport& transport;
+    Ocean ocean;
+    std::vector<std::uint8_t> outgoing;
+    std::vector<std::uint8_t> incoming;
+};
+
+#endif
\ No newline at end of file
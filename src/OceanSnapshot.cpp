@@ -0,0 +1,330 @@
+#include "Ocean.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OCEAN_SNAPSHOT_MMAP 1
+#endif
+
+// Формат снимка: заголовок фиксированного размера, затем массивы переднего
+// буфера в том виде, в каком они лежат в памяти (с рамкой, в раскладке поля),
+// и список активных плиток. Массивы не нужно разбирать: загрузка отображает их в память.
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'O', 'C', 'E', 'A', 'N', 'S', 'N', 'P'};
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+// Выравнивание массивов на 64 КиБ позволяет отображать каждый отдельно
+// при любом распространённом размере страницы.
+constexpr std::uint64_t SECTION_ALIGN = 64 * 1024;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::uint32_t byteOrder;
+    std::int32_t width;
+    std::int32_t height;
+    std::uint32_t boundary;      // Boundary
+    std::uint64_t seed;
+    std::int64_t tick;
+    std::uint64_t fillCount;
+    std::int64_t counts[4];
+    std::uint64_t cellCount;     // ячеек в буфере вместе с рамкой
+    std::uint64_t activeCount;
+    std::uint64_t cellsOffset;
+    std::uint64_t ageOffset;
+    std::uint64_t hungerOffset;
+    std::uint64_t activeOffset;
+    std::uint64_t fileSize;
+    // Параметры водорослей, травоядных и хищников в порядке
+    // maxAge, reproduceAge, maxHunger, hungerDecrease.
+    std::int32_t params[3][4];
+    std::uint32_t layout;        // GridLayout
+};
+
+std::uint64_t alignUp(std::uint64_t value) {
+    return (value + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+// Открытый файл снимка. Массивы поля отображаются в память с копией при
+// записи, поэтому загрузка не читает их: страницы подгружаются по мере того,
+// как такты до них доходят. Без mmap массивы читаются целиком.
+class SnapshotFile {
+public:
+    explicit SnapshotFile(const std::string& path) : path(path) {
+#ifdef OCEAN_SNAPSHOT_MMAP
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Ocean::loadSnapshot: Cannot open " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Ocean::loadSnapshot: Cannot stat " + path);
+        }
+        length = static_cast<std::uint64_t>(info.st_size);
+#else
+        in.open(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Ocean::loadSnapshot: Cannot open " + path);
+        }
+        in.seekg(0, std::ios::end);
+        length = static_cast<std::uint64_t>(in.tellg());
+#endif
+    }
+
+    ~SnapshotFile() {
+#ifdef OCEAN_SNAPSHOT_MMAP
+        ::close(fd);
+#endif
+    }
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    std::uint64_t size() const { return length; }
+
+    void read(std::uint64_t offset, void* out, std::uint64_t bytes) {
+#ifdef OCEAN_SNAPSHOT_MMAP
+        char* target = static_cast<char*>(out);
+        while (bytes > 0) {
+            ssize_t got = ::pread(fd, target, bytes, static_cast<off_t>(offset));
+            if (got <= 0) {
+                throw std::runtime_error("Ocean::loadSnapshot: Read failed for " + path);
+            }
+            target += got;
+            offset += static_cast<std::uint64_t>(got);
+            bytes -= static_cast<std::uint64_t>(got);
+        }
+#else
+        in.seekg(static_cast<std::streamoff>(offset));
+        in.read(static_cast<char*>(out), static_cast<std::streamsize>(bytes));
+        if (!in) {
+            throw std::runtime_error("Ocean::loadSnapshot: Read failed for " + path);
+        }
+#endif
+    }
+
+    template <class T>
+    CellArray<T> load(std::uint64_t offset, std::uint64_t count) {
+#ifdef OCEAN_SNAPSHOT_MMAP
+        std::uint64_t bytes = count * sizeof(T);
+        static const long pageSize = ::sysconf(_SC_PAGESIZE);
+        if (bytes > 0 && pageSize > 0 && offset % static_cast<std::uint64_t>(pageSize) == 0) {
+            void* mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(offset));
+            if (mapped != MAP_FAILED) {
+                std::shared_ptr<void> mapping(mapped, [bytes](void* p) { ::munmap(p, bytes); });
+                return CellArray<T>::adopt(std::move(mapping), static_cast<T*>(mapped), count);
+            }
+        }
+#endif
+        CellArray<T> result(count, T{});
+        read(offset, result.data(), count * sizeof(T));
+        return result;
+    }
+
+private:
+    std::string path;
+    std::uint64_t length = 0;
+#ifdef OCEAN_SNAPSHOT_MMAP
+    int fd = -1;
+#else
+    std::ifstream in;
+#endif
+};
+
+void writeSection(std::ofstream& out, std::uint64_t offset, const void* data, std::uint64_t bytes) {
+    static const char zeros[SECTION_ALIGN] = {};
+    std::uint64_t position = static_cast<std::uint64_t>(out.tellp());
+    out.write(zeros, static_cast<std::streamsize>(offset - position));
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+
+}
+
+void Ocean::saveSnapshot(const std::string& path) const {
+    const Impl& impl = *pimpl;
+    const Buffer& grid = impl.front;
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.width = grid.width;
+    header.height = grid.height;
+    header.boundary = static_cast<std::uint32_t>(impl.boundary);
+    header.seed = impl.seed;
+    header.tick = impl.tickCount;
+    header.fillCount = impl.fillCount;
+    for (std::size_t type = 0; type < impl.counts.size(); ++type) {
+        header.counts[type] = impl.counts[type];
+    }
+    header.cellCount = grid.cells.size();
+    header.activeCount = impl.active.tiles.size();
+    header.cellsOffset = alignUp(sizeof(SnapshotHeader));
+    header.ageOffset = alignUp(header.cellsOffset + header.cellCount);
+    header.hungerOffset = alignUp(header.ageOffset + header.cellCount * sizeof(std::uint16_t));
+    header.activeOffset = alignUp(header.hungerOffset + header.cellCount * sizeof(std::uint16_t));
+    header.fileSize = header.activeOffset + header.activeCount * sizeof(std::int32_t);
+    for (int species = 0; species < 3; ++species) {
+        const SpeciesParams& params = impl.params[static_cast<EntityType>(species + 1)];
+        header.params[species][0] = params.maxAge;
+        header.params[species][1] = params.reproduceAge;
+        header.params[species][2] = params.maxHunger;
+        header.params[species][3] = params.hungerDecrease;
+    }
+    header.layout = static_cast<std::uint32_t>(grid.layout);
+
+    // Пишем во временный файл и переименовываем, чтобы оборванная запись
+    // не испортила предыдущий снимок.
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Ocean::saveSnapshot: Cannot create " + temporary);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(out, header.cellsOffset, grid.cells.data(), header.cellCount);
+        writeSection(out, header.ageOffset, grid.age.data(), header.cellCount * sizeof(std::uint16_t));
+        writeSection(out, header.hungerOffset, grid.hunger.data(), header.cellCount * sizeof(std::uint16_t));
+        std::vector<std::int32_t> active(impl.active.tiles.begin(), impl.active.tiles.end());
+        writeSection(out, header.activeOffset, active.data(), header.activeCount * sizeof(std::int32_t));
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Ocean::saveSnapshot: Write failed for " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Ocean::saveSnapshot: Cannot rename " + temporary + " to " + path);
+    }
+}
+
+Ocean Ocean::loadSnapshot(const std::string& path, bool verifyCells) {
+    SnapshotFile file(path);
+    SnapshotHeader header{};
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error("Ocean::loadSnapshot: " + path + " is too short to be a snapshot");
+    }
+    file.read(0, &header, sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Ocean::loadSnapshot: " + path + " is not an ocean snapshot");
+    }
+    if (header.version != SNAPSHOT_VERSION || header.headerSize != sizeof(header)) {
+        throw std::runtime_error("Ocean::loadSnapshot: Unsupported snapshot version " + std::to_string(header.version));
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Ocean::loadSnapshot: Snapshot was written with a different byte order");
+    }
+    if (header.width <= 0 || header.height <= 0 || header.fileSize != file.size() ||
+        header.boundary > static_cast<std::uint32_t>(Boundary::Reflect) ||
+        header.layout > static_cast<std::uint32_t>(GridLayout::Morton) ||
+        (header.boundary != 0 && (header.width < 3 || header.height < 3))) {
+        throw std::runtime_error("Ocean::loadSnapshot: " + path + " is truncated or corrupt");
+    }
+    long long area = static_cast<long long>(header.width) * header.height;
+    long long total = 0;
+    for (std::int64_t count : header.counts) {
+        if (count < 0 || count > area) {
+            throw std::runtime_error("Ocean::loadSnapshot: " + path + " has inconsistent population counts");
+        }
+        total += count;
+    }
+    if (total != area) {
+        throw std::runtime_error("Ocean::loadSnapshot: " + path + " has inconsistent population counts");
+    }
+    EcosystemParams params;
+    for (int species = 0; species < 3; ++species) {
+        params[static_cast<EntityType>(species + 1)] = {header.params[species][0], header.params[species][1],
+                                                         header.params[species][2], header.params[species][3]};
+    }
+    try {
+        params.validate();
+    } catch (const std::invalid_argument&) {
+        throw std::runtime_error("Ocean::loadSnapshot: " + path + " has invalid species parameters");
+    }
+
+    auto impl = std::make_unique<Impl>(header.width, header.height, header.seed,
+                                       static_cast<Boundary>(header.boundary),
+                                       static_cast<GridLayout>(header.layout), false);
+    std::uint64_t tiles = static_cast<std::uint64_t>(impl->tiles.count());
+    std::uint64_t cellCount = impl->front.cellCount;
+    if (header.cellCount != cellCount || header.activeCount > tiles ||
+        header.cellsOffset + cellCount > header.ageOffset ||
+        header.ageOffset + cellCount * sizeof(std::uint16_t) > header.hungerOffset ||
+        header.hungerOffset + cellCount * sizeof(std::uint16_t) > header.activeOffset ||
+        header.activeOffset + header.activeCount * sizeof(std::int32_t) > file.size()) {
+        throw std::runtime_error("Ocean::loadSnapshot: " + path + " is truncated or corrupt");
+    }
+    std::vector<std::int32_t> active(header.activeCount);
+    file.read(header.activeOffset, active.data(), header.activeCount * sizeof(std::int32_t));
+    for (std::int32_t tile : active) {
+        if (tile < 0 || static_cast<std::uint64_t>(tile) >= tiles) {
+            throw std::runtime_error("Ocean::loadSnapshot: " + path + " is truncated or corrupt");
+        }
+        impl->active.insert(tile);
+    }
+
+    // Оба буфера смотрят в один файл независимыми копиями, поэтому задний
+    // сразу совпадает с передним и такт трогает только страницы активных плиток.
+    for (Buffer* buffer : {&impl->front, &impl->back}) {
+        buffer->cells = file.load<EntityType>(header.cellsOffset, cellCount);
+        buffer->age = file.load<std::uint16_t>(header.ageOffset, cellCount);
+        buffer->hunger = file.load<std::uint16_t>(header.hungerOffset, cellCount);
+    }
+    // Дыра в рамке дала бы чтение за краем поля, поэтому рамка проверяется
+    // всегда: это O(W+H) клеток.
+    const Buffer& grid = impl->front;
+    bool intact = true;
+    for (int x = -1; x <= header.width; ++x) {
+        intact = intact && grid.cells[grid.index(x, -1)] == BORDER_CELL &&
+                 grid.cells[grid.index(x, header.height)] == BORDER_CELL;
+    }
+    for (int y = 0; y < header.height; ++y) {
+        intact = intact && grid.cells[grid.index(-1, y)] == BORDER_CELL &&
+                 grid.cells[grid.index(header.width, y)] == BORDER_CELL;
+    }
+    if (!intact) {
+        throw std::runtime_error("Ocean::loadSnapshot: " + path + " is truncated or corrupt");
+    }
+    // Сами клетки просматриваются только по просьбе: проход по всему полю
+    // отнял бы у загрузки её O(1). Проверяются известность типов, численность
+    // из заголовка и то, что каждое существо лежит в активной плитке.
+    if (verifyCells) {
+        EntityCounts found{};
+        for (int y = 0; y < header.height; ++y) {
+            for (int x = 0; x < header.width; ++x) {
+                EntityType cell = grid.cells[grid.index(x, y)];
+                if (static_cast<std::size_t>(cell) >= found.size() ||
+                    (cell != EntityType::Sand && !impl->active.flags[impl->tiles.tileOf(x, y)])) {
+                    throw std::runtime_error("Ocean::loadSnapshot: " + path + " is truncated or corrupt");
+                }
+                ++found[static_cast<std::size_t>(cell)];
+            }
+        }
+        for (std::size_t type = 0; type < found.size(); ++type) {
+            if (header.counts[type] != found[type]) {
+                throw std::runtime_error("Ocean::loadSnapshot: " + path + " has inconsistent population counts");
+            }
+        }
+    }
+    for (std::size_t type = 0; type < impl->counts.size(); ++type) {
+        impl->counts[type] = header.counts[type];
+    }
+    impl->tickCount = header.tick;
+    impl->fillCount = header.fillCount;
+    impl->params = params;
+    impl->customParams = !params.isDefault();
+    return Ocean(std::move(impl));
+}
\ No newline at end of file
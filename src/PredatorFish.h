@@ -3,21 +3,16 @@
 
 #include "Entity.h"
 #include "EntityType.h"
+#include "SpeciesParams.h"
 #include <memory>
-#include <vector>
-#include <utility>
-#include <random>
-#include <algorithm>
-#include <tuple>
 
 class PredatorFish : public Entity {
-    int age = 0;
-    int hunger = 0;
-    static constexpr int MAX_AGE = 70;
-    static constexpr int MAX_HUNGER = 15;
-    static constexpr int REPRODUCE_AGE = 15;
-    static constexpr int HUNGER_DECREASE = 7;
 public:
+    static constexpr int MAX_AGE = DefaultSpeciesParams<EntityType::PredatorFish>::maxAge;
+    static constexpr int MAX_HUNGER = DefaultSpeciesParams<EntityType::PredatorFish>::maxHunger;
+    static constexpr int REPRODUCE_AGE = DefaultSpeciesParams<EntityType::PredatorFish>::reproduceAge;
+    static constexpr int HUNGER_DECREASE = DefaultSpeciesParams<EntityType::PredatorFish>::hungerDecrease;
+
     EntityType getType() const override;
     std::unique_ptr<Entity> clone() const override;
     void tick(int x, int y, IOcean& current, IWritableOcean& next) override;
@@ -0,0 +1,106 @@
+#include "Seeding.h"
+#include "CounterRandom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::uint64_t CLUSTER_STREAM = 0x636C7573ULL;
+
+// Следующее число заголовка PGM; комментарии от # до конца строки пропускаются.
+long readHeaderValue(std::istream& in, const std::string& path) {
+    in >> std::ws;
+    while (in.peek() == '#') {
+        std::string comment;
+        std::getline(in, comment);
+        in >> std::ws;
+    }
+    long value = -1;
+    if (!(in >> value) || value <= 0) {
+        throw std::runtime_error("loadDensityMap: " + path + " has a malformed PGM header");
+    }
+    return value;
+}
+
+}
+
+std::vector<float> clusterDensity(int width, int height, int clusters, double radius,
+                                  std::uint64_t seed, float background) {
+    if (width <= 0 || height <= 0 || clusters < 0 || !(radius > 0) || !(background >= 0)) {
+        throw std::invalid_argument("clusterDensity: Size, cluster count, radius and background are out of range.");
+    }
+    std::vector<float> density(static_cast<std::size_t>(width) * height, background);
+    CounterRandom gen(CounterRandom::key(seed, 0), CLUSTER_STREAM);
+    int reach = static_cast<int>(std::ceil(3 * radius));
+    double scale = -0.5 / (radius * radius);
+    for (int c = 0; c < clusters; ++c) {
+        int cx = static_cast<int>(gen.below(static_cast<std::uint32_t>(width)));
+        int cy = static_cast<int>(gen.below(static_cast<std::uint32_t>(height)));
+        for (int y = std::max(0, cy - reach); y <= std::min(height - 1, cy + reach); ++y) {
+            float* row = density.data() + static_cast<std::size_t>(y) * width;
+            for (int x = std::max(0, cx - reach); x <= std::min(width - 1, cx + reach); ++x) {
+                double dx = x - cx, dy = y - cy;
+                row[x] += static_cast<float>(std::exp((dx * dx + dy * dy) * scale));
+            }
+        }
+    }
+    return density;
+}
+
+std::vector<float> loadDensityMap(const std::string& path, int width, int height) {
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("loadDensityMap: Width and height must be positive.");
+    }
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("loadDensityMap: Cannot open " + path);
+    }
+    char magic[2] = {};
+    in.read(magic, 2);
+    bool binary = magic[0] == 'P' && magic[1] == '5';
+    if (!binary && !(magic[0] == 'P' && magic[1] == '2')) {
+        throw std::runtime_error("loadDensityMap: " + path + " is not a PGM image");
+    }
+    long imageWidth = readHeaderValue(in, path);
+    long imageHeight = readHeaderValue(in, path);
+    long maxValue = readHeaderValue(in, path);
+    if (maxValue > 65535) {
+        throw std::runtime_error("loadDensityMap: " + path + " has a malformed PGM header");
+    }
+
+    std::vector<float> pixels(static_cast<std::size_t>(imageWidth) * imageHeight);
+    if (binary) {
+        // После maxval ровно один пробельный символ, затем данные; 16 бит — старший байт первым.
+        in.get();
+        int bytes = maxValue > 255 ? 2 : 1;
+        std::vector<unsigned char> raw(pixels.size() * bytes);
+        in.read(reinterpret_cast<char*>(raw.data()), static_cast<std::streamsize>(raw.size()));
+        if (!in) {
+            throw std::runtime_error("loadDensityMap: " + path + " is truncated");
+        }
+        for (std::size_t i = 0; i < pixels.size(); ++i) {
+            pixels[i] = bytes == 2 ? static_cast<float>(raw[2 * i] << 8 | raw[2 * i + 1]) : raw[i];
+        }
+    } else {
+        for (float& pixel : pixels) {
+            long value = -1;
+            if (!(in >> value) || value < 0 || value > maxValue) {
+                throw std::runtime_error("loadDensityMap: " + path + " is truncated or corrupt");
+            }
+            pixel = static_cast<float>(value);
+        }
+    }
+
+    std::vector<float> density(static_cast<std::size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        long sy = static_cast<long>(static_cast<long long>(y) * imageHeight / height);
+        for (int x = 0; x < width; ++x) {
+            long sx = static_cast<long>(static_cast<long long>(x) * imageWidth / width);
+            density[static_cast<std::size_t>(y) * width + x] = pixels[static_cast<std::size_t>(sy) * imageWidth + sx];
+        }
+    }
+    return density;
+}
\ No newline at end of file
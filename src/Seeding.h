@@ -0,0 +1,22 @@
+#ifndef SEEDING_H
+#define SEEDING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Карты плотности для Ocean::randomFill: width * height неотрицательных весов
+// построчно. Важно только отношение весов, а не их масштаб.
+
+// clusters гауссовых пятен с радиусом radius (сигма) в случайных местах,
+// выбранных по seed, плюс одинаковый фон background во всех клетках.
+// Пятно обрезается на расстоянии 3 * radius от центра.
+std::vector<float> clusterDensity(int width, int height, int clusters, double radius,
+                                  std::uint64_t seed, float background = 0.0f);
+
+// Читает карту из изображения PGM (P2 или P5, 8 или 16 бит) и растягивает её
+// на поле width x height по ближайшему пикселю; яркость пикселя — вес.
+// Ошибки формата — std::runtime_error.
+std::vector<float> loadDensityMap(const std::string& path, int width, int height);
+
+#endif
\ No newline at end of file
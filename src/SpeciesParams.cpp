@@ -0,0 +1,88 @@
+#include "SpeciesParams.h"
+
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    std::size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    std::size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+const char* const SECTION_NAMES[] = {"sand", "algae", "herbivores", "predators"};
+
+}
+
+void EcosystemParams::validate() const {
+    // Возраст и голод хранятся в uint16 и растут на единицу до проверки.
+    const int limit = std::numeric_limits<std::uint16_t>::max() - 1;
+    for (EntityType type : {EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+        const SpeciesParams& params = (*this)[type];
+        bool fish = type != EntityType::Algae;
+        if (params.maxAge < 1 || params.maxAge > limit || params.reproduceAge < 0 ||
+            (fish && (params.maxHunger < 1 || params.maxHunger > limit || params.hungerDecrease < 0))) {
+            throw std::invalid_argument(std::string("EcosystemParams: Parameters of ") +
+                                        SECTION_NAMES[static_cast<std::size_t>(type)] + " are out of range.");
+        }
+    }
+}
+
+EcosystemParams loadEcosystemParams(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("loadEcosystemParams: Cannot open " + path);
+    }
+    EcosystemParams params;
+    SpeciesParams* section = nullptr;
+    std::string line;
+    for (int number = 1; std::getline(in, line); ++number) {
+        auto fail = [&](const std::string& message) {
+            throw std::runtime_error(path + ":" + std::to_string(number) + ": " + message);
+        };
+        std::size_t comment = line.find_first_of("#;");
+        line = trim(comment == std::string::npos ? line : line.substr(0, comment));
+        if (line.empty()) {
+            continue;
+        }
+        if (line.front() == '[') {
+            if (line.back() != ']') fail("unterminated section header");
+            std::string name = trim(line.substr(1, line.size() - 2));
+            section = nullptr;
+            for (std::size_t type = 1; type < 4; ++type) {
+                if (name == SECTION_NAMES[type]) section = &params.species[type];
+            }
+            if (section == nullptr) fail("unknown species '" + name + "'");
+            continue;
+        }
+        std::size_t equals = line.find('=');
+        if (equals == std::string::npos) fail("expected key = value");
+        if (section == nullptr) fail("value outside of a species section");
+        std::string key = trim(line.substr(0, equals));
+        std::string text = trim(line.substr(equals + 1));
+        int value = 0;
+        try {
+            std::size_t used = 0;
+            value = std::stoi(text, &used);
+            if (used != text.size()) fail("invalid number '" + text + "'");
+        } catch (const std::logic_error&) {
+            fail("invalid number '" + text + "'");
+        }
+        if (key == "max_age") section->maxAge = value;
+        else if (key == "reproduce_age") section->reproduceAge = value;
+        else if (key == "max_hunger") section->maxHunger = value;
+        else if (key == "hunger_decrease") section->hungerDecrease = value;
+        else fail("unknown key '" + key + "'");
+    }
+    try {
+        params.validate();
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+    return params;
+}
\ No newline at end of file
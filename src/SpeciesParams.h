@@ -0,0 +1,93 @@
+#ifndef SPECIES_PARAMS_H
+#define SPECIES_PARAMS_H
+
+#include "EntityType.h"
+#include <array>
+#include <cstddef>
+#include <string>
+
+// Параметры правил одного вида. У водорослей голода нет, maxHunger и
+// hungerDecrease для них не используются.
+struct SpeciesParams {
+    int maxAge = 0;
+    int reproduceAge = 0;
+    int maxHunger = 0;
+    int hungerDecrease = 0;
+
+    bool operator==(const SpeciesParams& other) const {
+        return maxAge == other.maxAge && reproduceAge == other.reproduceAge &&
+               maxHunger == other.maxHunger && hungerDecrease == other.hungerDecrease;
+    }
+    bool operator!=(const SpeciesParams& other) const { return !(*this == other); }
+};
+
+// Параметры по умолчанию, известные при компиляции. Ядра обращаются к полям
+// так же, как к SpeciesParams, поэтому с ними константы подставляются в код.
+// Константы классов Algae, HerbivoreFish и PredatorFish берутся отсюда.
+template <EntityType Type>
+struct DefaultSpeciesParams;
+
+template <>
+struct DefaultSpeciesParams<EntityType::Algae> {
+    static constexpr int maxAge = 20;
+    static constexpr int reproduceAge = 5;
+    static constexpr int maxHunger = 0;
+    static constexpr int hungerDecrease = 0;
+};
+
+template <>
+struct DefaultSpeciesParams<EntityType::HerbivoreFish> {
+    static constexpr int maxAge = 50;
+    static constexpr int reproduceAge = 10;
+    static constexpr int maxHunger = 10;
+    static constexpr int hungerDecrease = 5;
+};
+
+template <>
+struct DefaultSpeciesParams<EntityType::PredatorFish> {
+    static constexpr int maxAge = 70;
+    static constexpr int reproduceAge = 15;
+    static constexpr int maxHunger = 15;
+    static constexpr int hungerDecrease = 7;
+};
+
+template <EntityType Type>
+constexpr SpeciesParams defaultSpeciesParams() {
+    using Defaults = DefaultSpeciesParams<Type>;
+    return {Defaults::maxAge, Defaults::reproduceAge, Defaults::maxHunger, Defaults::hungerDecrease};
+}
+
+// Параметры всех видов; индекс — EntityType, у песка параметров нет.
+struct EcosystemParams {
+    std::array<SpeciesParams, 4> species{{
+        {},
+        defaultSpeciesParams<EntityType::Algae>(),
+        defaultSpeciesParams<EntityType::HerbivoreFish>(),
+        defaultSpeciesParams<EntityType::PredatorFish>(),
+    }};
+
+    const SpeciesParams& operator[](EntityType type) const { return species[static_cast<std::size_t>(type)]; }
+    SpeciesParams& operator[](EntityType type) { return species[static_cast<std::size_t>(type)]; }
+
+    bool isDefault() const { return *this == EcosystemParams{}; }
+    bool operator==(const EcosystemParams& other) const { return species == other.species; }
+    bool operator!=(const EcosystemParams& other) const { return !(*this == other); }
+
+    // Бросает std::invalid_argument, если значения не имеют смысла
+    // или не помещаются в 16-битные счётчики возраста и голода.
+    void validate() const;
+};
+
+// Читает параметры из текстового файла вида
+//
+//     # комментарий
+//     [herbivores]
+//     max_age = 60
+//     hunger_decrease = 4
+//
+// Секции: algae, herbivores, predators; ключи: max_age, reproduce_age,
+// max_hunger, hunger_decrease. Не указанные значения остаются по умолчанию.
+// Ошибки формата — std::runtime_error с номером строки.
+EcosystemParams loadEcosystemParams(const std::string& path);
+
+#endif
\ No newline at end of file
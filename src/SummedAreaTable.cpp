@@ -0,0 +1,152 @@
+#include "SummedAreaTable.h"
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+SummedAreaTable::SummedAreaTable(int width, int height) {
+    resize(width, height);
+}
+
+void SummedAreaTable::resize(int width, int height) {
+    if (width < 0 || height < 0) {
+        throw std::invalid_argument("SummedAreaTable: Width and height must not be negative.");
+    }
+    this->width = width;
+    this->height = height;
+    stride = static_cast<std::size_t>(width) + 1;
+    // Нулевые первая строка и первый столбец избавляют запросы от проверок.
+    sums.assign(stride * (static_cast<std::size_t>(height) + 1) * SPECIES, 0);
+}
+
+namespace {
+
+// Суммы внутри строки; с Above к ним прибавляется строка таблицы выше.
+template <bool Above>
+void prefixRow(const EntityType* cells, int width, const std::uint32_t* above, std::uint32_t* out) {
+    std::uint32_t a = 0, h = 0, p = 0;
+    for (int x = 0; x < width; ++x, out += 3) {
+        EntityType type = cells[x];
+        a += type == EntityType::Algae;
+        h += type == EntityType::HerbivoreFish;
+        p += type == EntityType::PredatorFish;
+        out[0] = a;
+        out[1] = h;
+        out[2] = p;
+        if constexpr (Above) {
+            out[0] += above[0];
+            out[1] += above[1];
+            out[2] += above[2];
+            above += 3;
+        }
+    }
+}
+
+}
+
+void SummedAreaTable::addRow(int y, const EntityType* cells) {
+    if (y < 0 || y >= height) {
+        throw std::out_of_range("SummedAreaTable::addRow: Row out of bounds");
+    }
+    std::uint32_t* row = rowData(y) + SPECIES;
+    prefixRow<true>(cells, width, row - stride * SPECIES, row);
+}
+
+void SummedAreaTable::sumRow(int y, const EntityType* cells) {
+    if (y < 0 || y >= height) {
+        throw std::out_of_range("SummedAreaTable::sumRow: Row out of bounds");
+    }
+    prefixRow<false>(cells, width, nullptr, rowData(y) + SPECIES);
+}
+
+void SummedAreaTable::accumulateColumns(int x0, int x1) {
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, width);
+    if (x0 >= x1) {
+        return;
+    }
+    std::size_t begin = static_cast<std::size_t>(x0 + 1) * SPECIES;
+    std::size_t end = static_cast<std::size_t>(x1 + 1) * SPECIES;
+    for (int y = 1; y < height; ++y) {
+        const std::uint32_t* above = rowData(y - 1);
+        std::uint32_t* row = rowData(y);
+        for (std::size_t i = begin; i < end; ++i) {
+            row[i] += above[i];
+        }
+    }
+}
+
+long long SummedAreaTable::count(EntityType type, int x, int y, int w, int h) const {
+    int x0 = std::max(x, 0), y0 = std::max(y, 0);
+    int x1 = static_cast<int>(std::min<long long>(static_cast<long long>(x) + w, width));
+    int y1 = static_cast<int>(std::min<long long>(static_cast<long long>(y) + h, height));
+    if (x0 >= x1 || y0 >= y1) {
+        return 0;
+    }
+    std::size_t index = static_cast<std::size_t>(type);
+    if (index > SPECIES) {
+        return 0;
+    }
+    if (type == EntityType::Sand) {
+        long long area = static_cast<long long>(x1 - x0) * (y1 - y0);
+        return area - count(EntityType::Algae, x0, y0, x1 - x0, y1 - y0) -
+               count(EntityType::HerbivoreFish, x0, y0, x1 - x0, y1 - y0) -
+               count(EntityType::PredatorFish, x0, y0, x1 - x0, y1 - y0);
+    }
+    std::uint32_t total = corner(index, x1, y1) - corner(index, x0, y1) - corner(index, x1, y0) + corner(index, x0, y0);
+    return total;
+}
+
+EntityCounts SummedAreaTable::countAll(int x, int y, int w, int h) const {
+    EntityCounts counts{};
+    for (std::size_t type = 0; type < counts.size(); ++type) {
+        counts[type] = count(static_cast<EntityType>(type), x, y, w, h);
+    }
+    return counts;
+}
+
+void SummedAreaTable::heatmap(int block, Heatmap& out) const {
+    out.resize(width, height, block);
+    for (int by = 0; by < out.blocksY; ++by) {
+        for (int bx = 0; bx < out.blocksX; ++bx) {
+            EntityCounts counts = countAll(bx * block, by * block, block, block);
+            std::size_t i = static_cast<std::size_t>(by) * out.blocksX + bx;
+            for (std::size_t type = 0; type < counts.size(); ++type) {
+                out.counts[type][i] = static_cast<std::uint32_t>(counts[type]);
+            }
+        }
+    }
+}
+
+void Heatmap::resize(int width, int height, int block) {
+    if (width < 0 || height < 0 || block <= 0) {
+        throw std::invalid_argument("Heatmap: Size must not be negative and block must be positive.");
+    }
+    this->width = width;
+    this->height = height;
+    this->block = block;
+    blocksX = (width + block - 1) / block;
+    blocksY = (height + block - 1) / block;
+    for (std::vector<std::uint32_t>& plane : counts) {
+        plane.assign(static_cast<std::size_t>(blocksX) * blocksY, 0);
+    }
+}
+
+float Heatmap::density(EntityType type, int bx, int by) const {
+    int w = std::min(block, width - bx * block);
+    int h = std::min(block, height - by * block);
+    return static_cast<float>(at(type, bx, by)) / (static_cast<float>(w) * static_cast<float>(h));
+}
+
+void Heatmap::writeCsv(std::ostream& out) const {
+    out << "bx,by,sand,algae,herbivores,predators\n";
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            out << bx << ',' << by;
+            for (std::size_t type = 0; type < counts.size(); ++type) {
+                out << ',' << at(static_cast<EntityType>(type), bx, by);
+            }
+            out << '\n';
+        }
+    }
+}
\ No newline at end of file
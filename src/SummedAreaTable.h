@@ -0,0 +1,81 @@
+#ifndef SUMMED_AREA_TABLE_H
+#define SUMMED_AREA_TABLE_H
+
+#include "EntityType.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+struct Heatmap;
+
+// Таблица сумм по прямоугольникам (integral image) для каждого вида:
+// клетка (x, y) таблицы — число существ в [0, x) x [0, y). Число существ
+// в любом прямоугольнике считается за четыре чтения. Суммы хранятся по
+// модулю 2^32: разность четырёх углов всё равно точна, пока в прямоугольнике
+// меньше 2^32 клеток. Песок не хранится, он равен площади минус остальные виды.
+class SummedAreaTable {
+public:
+    SummedAreaTable(int width = 0, int height = 0);
+
+    void resize(int width, int height);
+
+    // Сборка за один проход: addRow для y = 0..height-1 строго по порядку,
+    // каждая строка — width значений EntityType.
+    void addRow(int y, const EntityType* cells);
+    // Сборка в два прохода для нескольких потоков: sumRow считает суммы внутри
+    // строки, accumulateColumns складывает строки сверху вниз в столбцах [x0, x1).
+    // Разные строки и разные полосы столбцов независимы; второй проход идёт
+    // после всех строк.
+    void sumRow(int y, const EntityType* cells);
+    void accumulateColumns(int x0, int x1);
+
+    // Число существ вида type в [x, x + w) x [y, y + h); прямоугольник
+    // обрезается по краям поля.
+    long long count(EntityType type, int x, int y, int w, int h) const;
+    EntityCounts countAll(int x, int y, int w, int h) const;
+
+    // Грубая карта плотности по блокам block x block, за O(число блоков).
+    void heatmap(int block, Heatmap& out) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    // Суммы трёх видов лежат рядом, поэтому запрос по всем видам читает
+    // по одной строке кэша на угол.
+    static constexpr std::size_t SPECIES = 3;
+
+    std::uint32_t corner(std::size_t type, int x, int y) const {
+        return sums[(static_cast<std::size_t>(y) * stride + static_cast<std::size_t>(x)) * SPECIES + type - 1];
+    }
+    std::uint32_t* rowData(int y) { return sums.data() + static_cast<std::size_t>(y + 1) * stride * SPECIES; }
+
+    int width = 0;
+    int height = 0;
+    std::size_t stride = 0;
+    std::vector<std::uint32_t> sums;
+};
+
+// Число существ каждого вида в блоках block x block; крайние блоки могут
+// быть меньше. Индекс массивов — EntityType, блок (bx, by) — by * blocksX + bx.
+struct Heatmap {
+    int width = 0;
+    int height = 0;
+    int block = 0;
+    int blocksX = 0;
+    int blocksY = 0;
+    std::array<std::vector<std::uint32_t>, 4> counts;
+
+    void resize(int width, int height, int block);
+    std::uint32_t at(EntityType type, int bx, int by) const {
+        return counts[static_cast<std::size_t>(type)][static_cast<std::size_t>(by) * blocksX + bx];
+    }
+    // Доля клеток блока, занятых видом.
+    float density(EntityType type, int bx, int by) const;
+    // Строка на блок: bx,by,sand,algae,herbivores,predators.
+    void writeCsv(std::ostream& out) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "ThreadPool.h"
+
+#include <stdexcept>
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount <= 0) {
+        throw std::invalid_argument("ThreadPool: Thread count must be positive.");
+    }
+    workers.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+void ThreadPool::run(std::size_t count, Call call, void* context) {
+    if (workers.empty() || count <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            call(context, i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->call = call;
+        this->context = context;
+        this->count = count;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busy = static_cast<int>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+}
+
+void ThreadPool::work(int worker) {
+    for (;;) {
+        std::size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count) {
+            return;
+        }
+        call(context, index, worker);
+    }
+}
+
+void ThreadPool::workerLoop(int worker) {
+    unsigned long long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        work(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0) {
+            done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Постоянный набор рабочих потоков для параллельных циклов. Вызывающий поток
+// участвует в работе как поток номер 0, поэтому ThreadPool(1) потоков не создаёт.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const;
+
+    // Вызывает function(index, worker) для каждого index из [0, count).
+    // Индексы раздаются динамически; worker — номер потока в [0, size()).
+    template <class Function>
+    void parallelFor(std::size_t count, Function&& function) {
+        using Target = std::remove_reference_t<Function>;
+        auto call = [](void* context, std::size_t index, int worker) {
+            (*static_cast<Target*>(context))(index, worker);
+        };
+        run(count, call, const_cast<std::remove_const_t<Target>*>(&function));
+    }
+
+private:
+    using Call = void (*)(void*, std::size_t, int);
+
+    void run(std::size_t count, Call call, void* context);
+    void work(int worker);
+    void workerLoop(int worker);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+    unsigned long long generation = 0;
+    int busy = 0;
+
+    Call call = nullptr;
+    void* context = nullptr;
+    std::size_t count = 0;
+    std::atomic<std::size_t> nextIndex{0};
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "TickStats.h"
+
+#include <ostream>
+
+namespace {
+
+const char* const EVENT_NAMES[TICK_EVENT_COUNT] = {
+    "births", "deaths_age", "deaths_hunger", "eats", "moves", "conflicts", "deaths_fight"};
+const char* const SPECIES_NAMES[4] = {"sand", "algae", "herbivores", "predators"};
+
+}
+
+void TickStats::merge(const TickStats& other) {
+    ticks += other.ticks;
+    syncSeconds += other.syncSeconds;
+    scheduleSeconds += other.scheduleSeconds;
+    updateSeconds += other.updateSeconds;
+    mergeSeconds += other.mergeSeconds;
+    for (std::size_t species = 0; species < speciesSeconds.size(); ++species) {
+        speciesSeconds[species] += other.speciesSeconds[species];
+    }
+    for (std::size_t event = 0; event < TICK_EVENT_COUNT; ++event) {
+        for (std::size_t species = 0; species < 4; ++species) {
+            events[event][species] += other.events[event][species];
+        }
+    }
+}
+
+// Плоский список «метрика,значение», удобный для склейки прогонов.
+void TickStats::writeCsv(std::ostream& out) const {
+    out << "metric,value\n"
+        << "ticks," << ticks << '\n'
+        << "time.sync_seconds," << syncSeconds << '\n'
+        << "time.schedule_seconds," << scheduleSeconds << '\n'
+        << "time.update_seconds," << updateSeconds << '\n'
+        << "time.merge_seconds," << mergeSeconds << '\n';
+    for (std::size_t species = 1; species < 4; ++species) {
+        out << "time." << SPECIES_NAMES[species] << "_seconds," << speciesSeconds[species] << '\n';
+    }
+    for (std::size_t event = 0; event < TICK_EVENT_COUNT; ++event) {
+        for (std::size_t species = 1; species < 4; ++species) {
+            out << EVENT_NAMES[event] << '.' << SPECIES_NAMES[species] << ',' << events[event][species] << '\n';
+        }
+    }
+}
+
+void TickStats::writeJson(std::ostream& out) const {
+    out << "{\n"
+        << "  \"ticks\": " << ticks << ",\n"
+        << "  \"time\": {\"sync_seconds\": " << syncSeconds
+        << ", \"schedule_seconds\": " << scheduleSeconds
+        << ", \"update_seconds\": " << updateSeconds
+        << ", \"merge_seconds\": " << mergeSeconds;
+    for (std::size_t species = 1; species < 4; ++species) {
+        out << ", \"" << SPECIES_NAMES[species] << "_seconds\": " << speciesSeconds[species];
+    }
+    out << "},\n";
+    for (std::size_t event = 0; event < TICK_EVENT_COUNT; ++event) {
+        out << "  \"" << EVENT_NAMES[event] << "\": {";
+        for (std::size_t species = 1; species < 4; ++species) {
+            out << (species > 1 ? ", " : "") << '"' << SPECIES_NAMES[species] << "\": " << events[event][species];
+        }
+        out << '}' << (event + 1 < TICK_EVENT_COUNT ? "," : "") << '\n';
+    }
+    out << "}\n";
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef TICK_STATS_H
+#define TICK_STATS_H
+
+#include "EntityType.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+#include <utility>
+
+// Инструментирование такта включается при сборке (-DOCEAN_STATS=ON в CMake).
+// Без него счётчики и таймеры не компилируются вовсе, а Ocean::getStats
+// возвращает нули.
+#ifndef OCEAN_STATS
+#define OCEAN_STATS 0
+#endif
+
+constexpr bool STATS_ENABLED = OCEAN_STATS != 0;
+
+// События правил видов. Конфликт — заявку существа на клетку выиграл другой,
+// и оно осталось на месте. Гибель в драке — добычу взяла другая рыба того же вида.
+enum class TickEvent : std::uint8_t { Birth, DeathByAge, DeathByHunger, Eat, Move, Conflict, DeathInFight };
+constexpr std::size_t TICK_EVENT_COUNT = 7;
+
+struct TickStats {
+    long long ticks = 0;
+    // Время фаз такта в секундах: копирование сетки, выбор плиток, заявки
+    // существ с их разбором и записью (по стене) и сведение результатов потоков.
+    double syncSeconds = 0;
+    double scheduleSeconds = 0;
+    double updateSeconds = 0;
+    double mergeSeconds = 0;
+    // Время ядер каждого вида, сумма по всем потокам: выбор заявок и их
+    // запись в сетку. Разбор спорных клеток ни одному виду не приписан.
+    std::array<double, 4> speciesSeconds{};
+    // events[событие][вид]
+    std::array<std::array<long long, 4>, TICK_EVENT_COUNT> events{};
+
+    long long count(TickEvent event, EntityType species) const {
+        return events[static_cast<std::size_t>(event)][static_cast<std::size_t>(species)];
+    }
+    void note(TickEvent event, EntityType species) {
+        ++events[static_cast<std::size_t>(event)][static_cast<std::size_t>(species)];
+    }
+    void merge(const TickStats& other);
+
+    void writeCsv(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+};
+
+// Ядра сообщают о событиях через noteEvent(next, ...). Сетки, которые умеют
+// считать (Writer), объявляют noteEvent; для остальных, как и в сборке без
+// статистики, вызов ничего не делает и исчезает при компиляции.
+template <class Grid, class = void>
+struct CountsEvents : std::false_type {};
+
+template <class Grid>
+struct CountsEvents<Grid, std::void_t<decltype(std::declval<Grid&>().noteEvent(TickEvent::Birth, EntityType::Sand))>>
+    : std::true_type {};
+
+// Секундомер для TickStats: lap прибавляет время с прошлого замера к into.
+// В сборке без статистики не обращается к часам.
+class TickTimer {
+public:
+    TickTimer() {
+        if constexpr (STATS_ENABLED) {
+            last = std::chrono::steady_clock::now();
+        }
+    }
+    void lap(double& into) {
+        if constexpr (STATS_ENABLED) {
+            auto now = std::chrono::steady_clock::now();
+            into += std::chrono::duration<double>(now - last).count();
+            last = now;
+        }
+    }
+
+private:
+    std::chrono::steady_clock::time_point last;
+};
+
+template <class Grid>
+inline void noteEvent(Grid& grid, TickEvent event, EntityType species) {
+    if constexpr (STATS_ENABLED && CountsEvents<Grid>::value) {
+        grid.noteEvent(event, species);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,481 @@
+#include "Trajectory.h"
+#include "Lz.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr char TRAJECTORY_MAGIC[8] = {'O', 'C', 'E', 'A', 'N', 'T', 'R', 'J'};
+constexpr char INDEX_MAGIC[8] = {'O', 'C', 'E', 'A', 'N', 'I', 'D', 'X'};
+constexpr std::uint32_t TRAJECTORY_VERSION = 1;
+constexpr std::uint64_t HEADER_SIZE = 24;
+constexpr std::uint8_t KEYFRAME = 0;
+constexpr std::uint8_t DELTA = 1;
+// Короткие совпадающие промежутки дешевле передать внутри участка.
+constexpr std::size_t MIN_GAP = 4;
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint64_t getVarint(const std::uint8_t*& in, const std::uint8_t* end) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (in >= end) {
+            throw std::runtime_error("TrajectoryReader: Corrupt frame payload");
+        }
+        std::uint8_t byte = *in++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("TrajectoryReader: Corrupt frame payload");
+}
+
+template <class T>
+void putFixed(std::vector<std::uint8_t>& out, T value) {
+    std::uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// Поле целиком: пары (тип, длина серии) построчно.
+void encodeKeyframe(const std::vector<EntityType>& cells, std::vector<std::uint8_t>& out) {
+    std::size_t n = cells.size();
+    for (std::size_t i = 0; i < n;) {
+        std::size_t j = i + 1;
+        while (j < n && cells[j] == cells[i]) {
+            ++j;
+        }
+        out.push_back(static_cast<std::uint8_t>(cells[i]));
+        putVarint(out, j - i);
+        i = j;
+    }
+}
+
+// Изменения: (пропуск, длина участка, новые значения участка).
+void encodeDelta(const std::vector<EntityType>& previous, const std::vector<EntityType>& cells,
+                 std::vector<std::uint8_t>& out) {
+    const std::uint8_t* before = reinterpret_cast<const std::uint8_t*>(previous.data());
+    const std::uint8_t* after = reinterpret_cast<const std::uint8_t*>(cells.data());
+    std::size_t n = cells.size();
+    std::size_t position = 0;
+    std::size_t i = 0;
+    while (true) {
+        // Неизменившиеся области пропускаем по 8 байт.
+        while (i + 8 <= n && std::memcmp(before + i, after + i, 8) == 0) {
+            i += 8;
+        }
+        while (i < n && before[i] == after[i]) {
+            ++i;
+        }
+        if (i >= n) {
+            break;
+        }
+        std::size_t j = i + 1;
+        while (j < n) {
+            if (before[j] != after[j]) {
+                ++j;
+                continue;
+            }
+            std::size_t gap = j;
+            while (gap < n && gap - j < MIN_GAP && before[gap] == after[gap]) {
+                ++gap;
+            }
+            if (gap < n && gap - j < MIN_GAP) {
+                j = gap;
+            } else {
+                break;
+            }
+        }
+        putVarint(out, i - position);
+        putVarint(out, j - i);
+        out.insert(out.end(), after + i, after + j);
+        position = j;
+        i = j;
+    }
+}
+
+void decodeKeyframe(const std::uint8_t* in, const std::uint8_t* end, std::vector<EntityType>& cells) {
+    std::size_t i = 0;
+    while (in < end) {
+        std::uint8_t type = *in++;
+        std::uint64_t length = getVarint(in, end);
+        if (type > static_cast<std::uint8_t>(EntityType::PredatorFish) || length > cells.size() - i) {
+            throw std::runtime_error("TrajectoryReader: Corrupt keyframe");
+        }
+        std::fill_n(cells.begin() + static_cast<std::ptrdiff_t>(i), length, static_cast<EntityType>(type));
+        i += length;
+    }
+    if (i != cells.size()) {
+        throw std::runtime_error("TrajectoryReader: Corrupt keyframe");
+    }
+}
+
+void decodeDelta(const std::uint8_t* in, const std::uint8_t* end, std::vector<EntityType>& cells) {
+    std::size_t i = 0;
+    while (in < end) {
+        std::uint64_t skip = getVarint(in, end);
+        std::uint64_t length = getVarint(in, end);
+        if (skip > cells.size() - i || length > cells.size() - i - skip ||
+            length > static_cast<std::uint64_t>(end - in)) {
+            throw std::runtime_error("TrajectoryReader: Corrupt delta frame");
+        }
+        i += skip;
+        for (std::uint64_t k = 0; k < length; ++k) {
+            if (in[k] > static_cast<std::uint8_t>(EntityType::PredatorFish)) {
+                throw std::runtime_error("TrajectoryReader: Corrupt delta frame");
+            }
+        }
+        std::memcpy(cells.data() + i, in, length);
+        in += length;
+        i += length;
+    }
+}
+
+}
+
+TrajectoryRecorder::TrajectoryRecorder(const std::string& path, int keyframeInterval, std::size_t queueLimit)
+    : path(path), keyframeInterval(keyframeInterval), queueLimit(queueLimit) {
+    if (keyframeInterval <= 0 || queueLimit == 0) {
+        throw std::invalid_argument("TrajectoryRecorder: Keyframe interval and queue limit must be positive.");
+    }
+    // Файл открывается только после проверки аргументов, чтобы неверный
+    // вызов не обнулил уже записанную траекторию.
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("TrajectoryRecorder: Cannot create " + path);
+    }
+    writer = std::thread(&TrajectoryRecorder::writerLoop, this);
+}
+
+TrajectoryRecorder::~TrajectoryRecorder() {
+    try {
+        close();
+    } catch (...) {
+        // Деструктор не бросает; кому важна ошибка записи, вызывает close сам.
+    }
+}
+
+void TrajectoryRecorder::rethrowFailure() {
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void TrajectoryRecorder::record(const Ocean& ocean) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (closing) {
+        throw std::logic_error("TrajectoryRecorder::record: Recorder is closed.");
+    }
+    if (framesRecorded == 0) {
+        width = ocean.getWidth();
+        height = ocean.getHeight();
+    } else if (ocean.getWidth() != width || ocean.getHeight() != height) {
+        throw std::invalid_argument("TrajectoryRecorder::record: Ocean size changed during recording.");
+    }
+    space.wait(lock, [this] { return pending.size() < queueLimit || failure; });
+    rethrowFailure();
+
+    // Память кадров переиспользуется, чтобы не выделять её на каждом такте.
+    OceanFrame frame;
+    if (!spare.empty()) {
+        frame = std::move(spare.back());
+        spare.pop_back();
+    }
+    lock.unlock();
+    ocean.captureFrame(frame);
+    lock.lock();
+    pending.push_back(std::move(frame));
+    ++framesRecorded;
+    wake.notify_one();
+}
+
+void TrajectoryRecorder::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) {
+            return;
+        }
+        closing = true;
+    }
+    wake.notify_one();
+    writer.join();
+    closed = true;
+    rethrowFailure();
+
+    std::vector<std::uint8_t> index;
+    std::uint64_t indexOffset = static_cast<std::uint64_t>(out.tellp());
+    putFixed<std::uint64_t>(index, keyframes.size());
+    for (const auto& [tick, offset] : keyframes) {
+        putFixed<std::int64_t>(index, tick);
+        putFixed<std::uint64_t>(index, offset);
+    }
+    putFixed<std::uint64_t>(index, indexOffset);
+    index.insert(index.end(), INDEX_MAGIC, INDEX_MAGIC + sizeof(INDEX_MAGIC));
+    out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("TrajectoryRecorder: Write failed for " + path);
+    }
+}
+
+void TrajectoryRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return !pending.empty() || closing; });
+        if (pending.empty()) {
+            return;
+        }
+        OceanFrame frame = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        try {
+            writeFrame(frame);
+        } catch (...) {
+            lock.lock();
+            failure = std::current_exception();
+            pending.clear();
+            space.notify_all();
+            return;
+        }
+        lock.lock();
+        // Обработанный кадр становится предыдущим, а старый предыдущий — запасным.
+        std::swap(frame, previous);
+        spare.push_back(std::move(frame));
+        space.notify_one();
+    }
+}
+
+void TrajectoryRecorder::writeFrame(const OceanFrame& frame) {
+    if (framesWritten == 0) {
+        std::vector<std::uint8_t> header;
+        header.insert(header.end(), TRAJECTORY_MAGIC, TRAJECTORY_MAGIC + sizeof(TRAJECTORY_MAGIC));
+        putFixed<std::uint32_t>(header, TRAJECTORY_VERSION);
+        putFixed<std::int32_t>(header, frame.width);
+        putFixed<std::int32_t>(header, frame.height);
+        putFixed<std::int32_t>(header, keyframeInterval);
+        out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    }
+
+    bool keyframe = framesWritten % keyframeInterval == 0;
+    payload.clear();
+    if (keyframe) {
+        encodeKeyframe(frame.cells, payload);
+        keyframes.emplace_back(frame.tick, static_cast<std::uint64_t>(out.tellp()));
+    } else {
+        encodeDelta(previous.cells, frame.cells, payload);
+    }
+
+    encoded.clear();
+    encoded.push_back(keyframe ? KEYFRAME : DELTA);
+    putVarint(encoded, static_cast<std::uint64_t>(frame.tick));
+    for (long long count : frame.counts) {
+        putVarint(encoded, static_cast<std::uint64_t>(count));
+    }
+    putVarint(encoded, payload.size());
+    std::size_t sizeAt = encoded.size();
+    lzCompress(payload.data(), payload.size(), encoded);
+    std::vector<std::uint8_t> length;
+    putVarint(length, encoded.size() - sizeAt);
+    encoded.insert(encoded.begin() + static_cast<std::ptrdiff_t>(sizeAt), length.begin(), length.end());
+
+    out.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+    if (!out) {
+        throw std::runtime_error("TrajectoryRecorder: Write failed for " + path);
+    }
+    ++framesWritten;
+}
+
+TrajectoryReader::TrajectoryReader(const std::string& path) : in(path, std::ios::binary), path(path) {
+    if (!in) {
+        throw std::runtime_error("TrajectoryReader: Cannot open " + path);
+    }
+    char header[HEADER_SIZE];
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC)) != 0) {
+        throw std::runtime_error("TrajectoryReader: " + path + " is not a trajectory file");
+    }
+    std::uint32_t version;
+    std::memcpy(&version, header + 8, sizeof(version));
+    std::memcpy(&width, header + 12, sizeof(width));
+    std::memcpy(&height, header + 16, sizeof(height));
+    std::memcpy(&keyframeInterval, header + 20, sizeof(keyframeInterval));
+    if (version != TRAJECTORY_VERSION) {
+        throw std::runtime_error("TrajectoryReader: Unsupported trajectory version " + std::to_string(version));
+    }
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("TrajectoryReader: " + path + " is corrupt");
+    }
+    dataBegin = HEADER_SIZE;
+
+    in.seekg(0, std::ios::end);
+    std::uint64_t fileSize = static_cast<std::uint64_t>(in.tellg());
+    dataEnd = fileSize;
+    bool indexed = false;
+    if (fileSize >= HEADER_SIZE + 24) {
+        char tail[16];
+        in.seekg(static_cast<std::streamoff>(fileSize - sizeof(tail)));
+        in.read(tail, sizeof(tail));
+        std::uint64_t indexOffset;
+        std::memcpy(&indexOffset, tail, sizeof(indexOffset));
+        if (in && std::memcmp(tail + 8, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+            indexOffset >= HEADER_SIZE && indexOffset + 8 + sizeof(tail) <= fileSize) {
+            std::uint64_t count;
+            in.seekg(static_cast<std::streamoff>(indexOffset));
+            in.read(reinterpret_cast<char*>(&count), sizeof(count));
+            if (in && count == (fileSize - indexOffset - 8 - sizeof(tail)) / 16) {
+                keyframes.resize(count);
+                for (auto& [tick, offset] : keyframes) {
+                    in.read(reinterpret_cast<char*>(&tick), sizeof(tick));
+                    in.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+                }
+                indexed = static_cast<bool>(in);
+                dataEnd = indexOffset;
+            }
+        }
+    }
+    in.clear();
+    if (!indexed) {
+        // Запись оборвалась до индекса: собираем его сами и отбрасываем недописанный хвост.
+        keyframes.clear();
+        dataEnd = fileSize;
+        scanRecords();
+    }
+    position = dataBegin;
+    current.width = width;
+    current.height = height;
+    current.cells.assign(static_cast<std::size_t>(width) * height, EntityType::Sand);
+}
+
+long long TrajectoryReader::getFirstTick() const {
+    if (keyframes.empty()) {
+        throw std::runtime_error("TrajectoryReader: " + path + " contains no frames");
+    }
+    return keyframes.front().first;
+}
+
+void TrajectoryReader::scanRecords() {
+    std::uint64_t offset = dataBegin;
+    in.seekg(static_cast<std::streamoff>(offset));
+    while (offset < dataEnd) {
+        // Заголовок записи занимает не больше 1 + 7 * 10 байт.
+        std::uint8_t head[71];
+        std::size_t available = static_cast<std::size_t>(std::min<std::uint64_t>(sizeof(head), dataEnd - offset));
+        in.seekg(static_cast<std::streamoff>(offset));
+        in.read(reinterpret_cast<char*>(head), static_cast<std::streamsize>(available));
+        if (!in) {
+            break;
+        }
+        try {
+            const std::uint8_t* p = head + 1;
+            const std::uint8_t* end = head + available;
+            long long tick = static_cast<long long>(getVarint(p, end));
+            for (int k = 0; k < 5; ++k) {
+                getVarint(p, end);
+            }
+            std::uint64_t compressedSize = getVarint(p, end);
+            std::uint64_t next = offset + static_cast<std::uint64_t>(p - head) + compressedSize;
+            if (next > dataEnd) {
+                break;
+            }
+            if (head[0] == KEYFRAME) {
+                keyframes.emplace_back(tick, offset);
+            }
+            offset = next;
+        } catch (const std::runtime_error&) {
+            break;
+        }
+    }
+    dataEnd = offset;
+    in.clear();
+}
+
+void TrajectoryReader::readRecord() {
+    std::uint8_t head[71];
+    std::size_t available = static_cast<std::size_t>(std::min<std::uint64_t>(sizeof(head), dataEnd - position));
+    in.seekg(static_cast<std::streamoff>(position));
+    if (!in.read(reinterpret_cast<char*>(head), static_cast<std::streamsize>(available))) {
+        throw std::runtime_error("TrajectoryReader: Read failed for " + path);
+    }
+    const std::uint8_t* p = head + 1;
+    const std::uint8_t* end = head + available;
+    std::uint8_t kind = head[0];
+    long long tick = static_cast<long long>(getVarint(p, end));
+    EntityCounts counts;
+    for (long long& count : counts) {
+        count = static_cast<long long>(getVarint(p, end));
+    }
+    std::uint64_t rawSize = getVarint(p, end);
+    std::uint64_t compressedSize = getVarint(p, end);
+    std::uint64_t payloadOffset = position + static_cast<std::uint64_t>(p - head);
+    if ((kind != KEYFRAME && kind != DELTA) || (kind == DELTA && !haveFrame) ||
+        compressedSize > dataEnd - payloadOffset || rawSize > 16 * current.cells.size() + 16) {
+        throw std::runtime_error("TrajectoryReader: " + path + " is corrupt");
+    }
+
+    compressed.resize(compressedSize);
+    in.seekg(static_cast<std::streamoff>(payloadOffset));
+    if (!in.read(reinterpret_cast<char*>(compressed.data()), static_cast<std::streamsize>(compressedSize))) {
+        throw std::runtime_error("TrajectoryReader: Read failed for " + path);
+    }
+    payload.resize(rawSize);
+    lzDecompress(compressed.data(), compressed.size(), payload.data(), payload.size());
+    if (kind == KEYFRAME) {
+        decodeKeyframe(payload.data(), payload.data() + payload.size(), current.cells);
+    } else {
+        decodeDelta(payload.data(), payload.data() + payload.size(), current.cells);
+    }
+    current.tick = tick;
+    current.counts = counts;
+    haveFrame = true;
+    position = payloadOffset + compressedSize;
+}
+
+bool TrajectoryReader::next() {
+    if (position >= dataEnd) {
+        return false;
+    }
+    readRecord();
+    return true;
+}
+
+void TrajectoryReader::seek(long long tick) {
+    auto after = std::upper_bound(keyframes.begin(), keyframes.end(), tick,
+                                  [](long long value, const auto& keyframe) { return value < keyframe.first; });
+    if (after == keyframes.begin()) {
+        throw std::out_of_range("TrajectoryReader::seek: Tick precedes the first recorded frame");
+    }
+    // Если нужный кадр уже позади текущего, ключевой кадр не нужен.
+    const auto& keyframe = *(after - 1);
+    if (!haveFrame || current.tick > tick || current.tick < keyframe.first) {
+        position = keyframe.second;
+        haveFrame = false;
+        readRecord();
+    }
+    std::uint64_t saved = position;
+    while (position < dataEnd) {
+        // Заглядываем в номер такта следующей записи, не декодируя её.
+        std::uint8_t head[11];
+        std::size_t available = static_cast<std::size_t>(std::min<std::uint64_t>(sizeof(head), dataEnd - position));
+        in.seekg(static_cast<std::streamoff>(position));
+        if (!in.read(reinterpret_cast<char*>(head), static_cast<std::streamsize>(available))) {
+            throw std::runtime_error("TrajectoryReader: Read failed for " + path);
+        }
+        const std::uint8_t* p = head + 1;
+        if (static_cast<long long>(getVarint(p, head + available)) > tick) {
+            break;
+        }
+        readRecord();
+        saved = position;
+    }
+    position = saved;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include "Ocean.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Файл траектории: заголовок, затем по записи на каждый записанный такт.
+// Запись — ключевой кадр (всё поле, RLE) или дельта к предыдущей записи
+// (изменившиеся участки), в обоих случаях сжатая lzCompress и снабжённая
+// численностью видов. В конце — индекс ключевых кадров для перемотки;
+// если запись оборвалась, читатель восстанавливает индекс проходом по файлу.
+
+// Записывает кадры Ocean в фоне: record копирует поле и сразу возвращается,
+// кодирование и запись на диск идут в отдельном потоке. Если поток не успевает,
+// record ждёт, пока в очереди не освободится место (queueLimit кадров).
+class TrajectoryRecorder {
+public:
+    TrajectoryRecorder(const std::string& path, int keyframeInterval = 100, std::size_t queueLimit = 4);
+    ~TrajectoryRecorder();
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    // Записывает текущее состояние ocean. Размер поля не должен меняться.
+    void record(const Ocean& ocean);
+    // Дописывает очередь и индекс и закрывает файл. Ошибки фонового потока
+    // пробрасываются отсюда или из следующего record.
+    void close();
+
+    long long getFramesRecorded() const { return framesRecorded; }
+
+private:
+    void writerLoop();
+    void writeFrame(const OceanFrame& frame);
+    void rethrowFailure();
+
+    std::ofstream out;
+    std::string path;
+    int keyframeInterval;
+    std::size_t queueLimit;
+    int width = 0;
+    int height = 0;
+    long long framesRecorded = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable space;
+    std::deque<OceanFrame> pending;
+    std::vector<OceanFrame> spare;
+    bool closing = false;
+    bool closed = false;
+    std::exception_ptr failure;
+    std::thread writer;
+
+    // Состояние фонового потока.
+    OceanFrame previous;
+    long long framesWritten = 0;
+    std::vector<std::pair<long long, std::uint64_t>> keyframes;
+    std::vector<std::uint8_t> payload;
+    std::vector<std::uint8_t> encoded;
+};
+
+// Читает файл траектории подряд или с перемоткой к любому записанному такту.
+class TrajectoryReader {
+public:
+    explicit TrajectoryReader(const std::string& path);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getKeyframeInterval() const { return keyframeInterval; }
+    long long getFirstTick() const;
+
+    // Переходит к следующей записи; false, если записи кончились.
+    bool next();
+    // Переходит к последней записи с номером такта не больше tick.
+    void seek(long long tick);
+    // Текущий кадр; до первого next/seek он пуст.
+    const OceanFrame& frame() const { return current; }
+
+private:
+    void scanRecords();
+    void readRecord();
+
+    std::ifstream in;
+    std::string path;
+    int width = 0;
+    int height = 0;
+    int keyframeInterval = 0;
+    std::uint64_t dataBegin = 0;
+    std::uint64_t dataEnd = 0;
+    std::uint64_t position = 0;
+    std::vector<std::pair<long long, std::uint64_t>> keyframes;
+    OceanFrame current;
+    bool haveFrame = false;
+    std::vector<std::uint8_t> compressed;
+    std::vector<std::uint8_t> payload;
+};
+
+#endif
\ No newline at end of file
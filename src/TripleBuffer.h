@@ -0,0 +1,44 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Передача последнего готового значения от одного писателя одному читателю
+// без блокировок. Писатель заполняет свой слот и публикует его, читатель
+// забирает самый свежий опубликованный слот; никто никого не ждёт, а
+// промежуточные значения, которые читатель не успел забрать, пропускаются.
+template <class T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initial) : slots{initial, initial, initial} {}
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Только для потока-писателя.
+    T& writeSlot() { return slots[writeIndex]; }
+    void publish() {
+        writeIndex = shared.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Только для потока-читателя. Возвращает true, если появилось новое значение.
+    bool acquire() {
+        if ((shared.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        readIndex = shared.exchange(readIndex, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& readSlot() const { return slots[readIndex]; }
+
+private:
+    static constexpr unsigned INDEX = 3;
+    static constexpr unsigned FRESH = 4;
+
+    T slots[3];
+    unsigned writeIndex = 0;
+    unsigned readIndex = 1;
+    std::atomic<unsigned> shared{2};
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Ensemble.h"
+#include "EntityType.h"
+
+namespace {
+
+// Доля клеток: одно значение или диапазон a:b, который делится поровну между участниками.
+struct FractionRange {
+    double first;
+    double last;
+
+    double at(int member, int members) const {
+        return members > 1 ? first + (last - first) * member / (members - 1) : first;
+    }
+};
+
+struct Options {
+    int members = 16;
+    int width = 80;
+    int height = 40;
+    FractionRange algae{1.0 / 10, 1.0 / 10};
+    FractionRange herbivores{1.0 / 50, 1.0 / 50};
+    FractionRange predators{1.0 / 150, 1.0 / 150};
+    std::uint64_t seed = 0;
+    Boundary boundary = Boundary::Walls;
+    std::string paramsPath;
+    long long ticks = 1000;
+    int threads = 1;
+    int batch = 32;
+    long long reportEvery = 1;
+    bool help = false;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --members N       number of independent oceans (16)\n"
+              << "  --width N         grid width of every member (80)\n"
+              << "  --height N        grid height of every member (40)\n"
+              << "  --algae F[:G]     algae fraction, or a range spread across members (0.1)\n"
+              << "  --herbivores F[:G] herbivore fraction (0.02)\n"
+              << "  --predators F[:G] predator fraction (0.00667)\n"
+              << "  --seed N          seed of the first member; member i uses N + i (0)\n"
+              << "  --boundary MODE   walls, torus or reflect (walls)\n"
+              << "  --params PATH     species parameters file shared by all members (built-in defaults)\n"
+              << "  --ticks N         number of ticks to run (1000)\n"
+              << "  --threads N       worker threads (1)\n"
+              << "  --batch N         ticks a member runs per scheduled task (32)\n"
+              << "  --report N        print the aggregate every N ticks (1)\n";
+}
+
+FractionRange parseRange(const std::string& value) {
+    std::size_t colon = value.find(':');
+    if (colon == std::string::npos) {
+        double fraction = std::stod(value);
+        return {fraction, fraction};
+    }
+    return {std::stod(value.substr(0, colon)), std::stod(value.substr(colon + 1))};
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string name = argv[i];
+        if (name == "--help" || name == "-h") {
+            options.help = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("missing value for " + name);
+        }
+        std::string value = argv[++i];
+        if (name == "--members") options.members = std::stoi(value);
+        else if (name == "--width") options.width = std::stoi(value);
+        else if (name == "--height") options.height = std::stoi(value);
+        else if (name == "--algae") options.algae = parseRange(value);
+        else if (name == "--herbivores") options.herbivores = parseRange(value);
+        else if (name == "--predators") options.predators = parseRange(value);
+        else if (name == "--seed") options.seed = std::stoull(value);
+        else if (name == "--boundary") options.boundary = parseBoundary(value);
+        else if (name == "--params") options.paramsPath = value;
+        else if (name == "--ticks") options.ticks = std::stoll(value);
+        else if (name == "--threads") options.threads = std::stoi(value);
+        else if (name == "--batch") options.batch = std::stoi(value);
+        else if (name == "--report") options.reportEvery = std::stoll(value);
+        else throw std::invalid_argument("unknown option " + name);
+    }
+    if (options.members <= 0) {
+        throw std::invalid_argument("--members must be positive");
+    }
+    return options;
+}
+
+const char* const SPECIES[] = {"algae", "herbivores", "predators"};
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.help) {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    try {
+        EcosystemParams params = options.paramsPath.empty() ? EcosystemParams{} : loadEcosystemParams(options.paramsPath);
+        std::vector<EnsembleMember> members(options.members);
+        for (int i = 0; i < options.members; ++i) {
+            EnsembleMember& member = members[i];
+            member.width = options.width;
+            member.height = options.height;
+            member.seed = options.seed + static_cast<std::uint64_t>(i);
+            member.algae = options.algae.at(i, options.members);
+            member.herbivores = options.herbivores.at(i, options.members);
+            member.predators = options.predators.at(i, options.members);
+            member.boundary = options.boundary;
+            member.params = params;
+        }
+        Ensemble ensemble(std::move(members));
+
+        std::cout << "tick";
+        for (const char* species : SPECIES) {
+            std::cout << ',' << species << "_mean," << species << "_var," << species << "_extinct";
+        }
+        std::cout << '\n';
+
+        auto printRow = [&](const EnsembleRow& row) {
+            if (options.reportEvery > 1 && row.tick % options.reportEvery != 0 && row.tick != options.ticks) {
+                return;
+            }
+            std::cout << row.tick;
+            for (int type = 1; type < 4; ++type) {
+                std::cout << ',' << row.mean[type] << ',' << row.variance[type] << ',' << row.extinct[type];
+            }
+            std::cout << '\n';
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        ensemble.run(options.ticks, options.threads, options.batch, printRow);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (int type = 1; type < 4; ++type) {
+            ExtinctionSummary summary = ensemble.extinctionSummary(static_cast<EntityType>(type));
+            std::cerr << SPECIES[type - 1] << ": extinct in " << summary.extinct << " of " << ensemble.size();
+            if (summary.extinct > 0) {
+                std::cerr << ", mean tick " << summary.meanTick << " (first " << summary.firstTick
+                          << ", last " << summary.lastTick << ')';
+            }
+            std::cerr << '\n';
+        }
+        double oceanTicks = static_cast<double>(options.ticks) * ensemble.size();
+        std::cerr << oceanTicks << " ocean ticks in " << seconds << " s, "
+                  << oceanTicks / seconds << " ocean ticks/s" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "Ocean.h"
+#include "Seeding.h"
+#include "Trajectory.h"
+#include "EntityType.h"
+
+namespace {
+
+struct Options {
+    int width = 80;
+    int height = 40;
+    double algae = 1.0 / 10;
+    double herbivores = 1.0 / 50;
+    double predators = 1.0 / 150;
+    std::uint64_t seed = 0;
+    Boundary boundary = Boundary::Walls;
+    GridLayout layout = GridLayout::Linear;
+    std::string paramsPath;
+    std::string densityPath;
+    int clusters = 0;
+    double clusterRadius = 8;
+    long long ticks = 1000;
+    int threads = 1;
+    long long reportEvery = 0;
+    std::string loadPath;
+    std::string savePath;
+    long long checkpointEvery = 0;
+    std::string recordPath;
+    int keyframeEvery = 100;
+    std::string statsPath;
+    std::string heatmapPath;
+    int heatmapBlock = 16;
+    bool help = false;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --width N         grid width (80)\n"
+              << "  --height N        grid height (40)\n"
+              << "  --algae F         fraction of cells seeded with algae (0.1)\n"
+              << "  --herbivores F    fraction of cells seeded with herbivores (0.02)\n"
+              << "  --predators F     fraction of cells seeded with predators (0.00667)\n"
+              << "  --seed N          random seed (0)\n"
+              << "  --boundary MODE   walls, torus or reflect (walls)\n"
+              << "  --layout MODE     cell order in memory: linear, tiled or morton (linear)\n"
+              << "  --params PATH     species parameters file (built-in defaults)\n"
+              << "  --density PATH    seed cells in proportion to a PGM density map (uniform)\n"
+              << "  --clusters N[:R]  seed into N random clusters of radius R (8) instead\n"
+              << "  --ticks N         number of ticks to run (1000)\n"
+              << "  --threads N       worker threads (1)\n"
+              << "  --report N        print populations every N ticks (0: only at the end)\n"
+              << "  --load PATH       resume from a snapshot instead of a random fill\n"
+              << "  --save PATH       write a snapshot at the end of the run\n"
+              << "  --checkpoint N    also write the --save snapshot every N ticks\n"
+              << "  --record PATH     record every tick to a compressed trajectory file\n"
+              << "  --keyframe N      full frame every N recorded ticks (100)\n"
+              << "  --heatmap PATH    write per-block population counts as CSV at the end\n"
+              << "  --heatmap-block N block size of --heatmap in cells (16)\n"
+              << "  --stats PATH      write tick timers and event counters (.json for JSON, otherwise CSV);\n"
+              << "                    needs a build with -DOCEAN_STATS=ON\n";
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string name = argv[i];
+        if (name == "--help" || name == "-h") {
+            options.help = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("missing value for " + name);
+        }
+        std::string value = argv[++i];
+        if (name == "--width") options.width = std::stoi(value);
+        else if (name == "--height") options.height = std::stoi(value);
+        else if (name == "--algae") options.algae = std::stod(value);
+        else if (name == "--herbivores") options.herbivores = std::stod(value);
+        else if (name == "--predators") options.predators = std::stod(value);
+        else if (name == "--seed") options.seed = std::stoull(value);
+        else if (name == "--boundary") options.boundary = parseBoundary(value);
+        else if (name == "--layout") options.layout = parseGridLayout(value);
+        else if (name == "--params") options.paramsPath = value;
+        else if (name == "--density") options.densityPath = value;
+        else if (name == "--clusters") {
+            std::size_t colon = value.find(':');
+            options.clusters = std::stoi(value.substr(0, colon));
+            if (colon != std::string::npos) options.clusterRadius = std::stod(value.substr(colon + 1));
+        }
+        else if (name == "--ticks") options.ticks = std::stoll(value);
+        else if (name == "--threads") options.threads = std::stoi(value);
+        else if (name == "--report") options.reportEvery = std::stoll(value);
+        else if (name == "--load") options.loadPath = value;
+        else if (name == "--save") options.savePath = value;
+        else if (name == "--checkpoint") options.checkpointEvery = std::stoll(value);
+        else if (name == "--record") options.recordPath = value;
+        else if (name == "--keyframe") options.keyframeEvery = std::stoi(value);
+        else if (name == "--stats") options.statsPath = value;
+        else if (name == "--heatmap") options.heatmapPath = value;
+        else if (name == "--heatmap-block") options.heatmapBlock = std::stoi(value);
+        else throw std::invalid_argument("unknown option " + name);
+    }
+    if (!options.statsPath.empty() && !STATS_ENABLED) {
+        throw std::invalid_argument("--stats requires a build with -DOCEAN_STATS=ON");
+    }
+    if (!options.densityPath.empty() && options.clusters > 0) {
+        throw std::invalid_argument("--density and --clusters are mutually exclusive");
+    }
+    if (options.checkpointEvery > 0 && options.savePath.empty()) {
+        throw std::invalid_argument("--checkpoint requires --save");
+    }
+    return options;
+}
+
+void writeStats(const Ocean& ocean, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("cannot create " + path);
+    }
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        ocean.getStats().writeJson(out);
+    } else {
+        ocean.getStats().writeCsv(out);
+    }
+}
+
+void writeHeatmap(const Ocean& ocean, const std::string& path, int block) {
+    Heatmap heatmap;
+    ocean.buildHeatmap(block, heatmap);
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("cannot create " + path);
+    }
+    heatmap.writeCsv(out);
+}
+
+void printCounts(const Ocean& ocean) {
+    EntityCounts counts = ocean.countAllEntities();
+    std::cout << ocean.getTickCount() << ','
+              << counts[static_cast<int>(EntityType::Algae)] << ','
+              << counts[static_cast<int>(EntityType::HerbivoreFish)] << ','
+              << counts[static_cast<int>(EntityType::PredatorFish)] << '\n';
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.help) {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    try {
+        // Снимок задаёт размер, зерно, номер такта и параметры видов; параметры
+        // заполнения игнорируются, а --params заменяет параметры из снимка.
+        Ocean ocean = options.loadPath.empty()
+                          ? Ocean(options.width, options.height, options.seed, options.boundary, options.layout)
+                          : Ocean::loadSnapshot(options.loadPath);
+        ocean.setThreadCount(options.threads);
+        if (!options.paramsPath.empty()) {
+            ocean.setSpeciesParams(loadEcosystemParams(options.paramsPath));
+        }
+
+        double cells = static_cast<double>(ocean.getWidth()) * ocean.getHeight();
+        if (options.loadPath.empty()) {
+            int algae = static_cast<int>(cells * options.algae);
+            int herbivores = static_cast<int>(cells * options.herbivores);
+            int predators = static_cast<int>(cells * options.predators);
+            if (!options.densityPath.empty()) {
+                ocean.randomFill(algae, herbivores, predators,
+                                 loadDensityMap(options.densityPath, ocean.getWidth(), ocean.getHeight()));
+            } else if (options.clusters > 0) {
+                // Слабый фон нужен, чтобы плотное заполнение не упиралось в размер пятен.
+                ocean.randomFill(algae, herbivores, predators,
+                                 clusterDensity(ocean.getWidth(), ocean.getHeight(), options.clusters,
+                                                options.clusterRadius, options.seed, 0.001f));
+            } else {
+                ocean.randomFill(algae, herbivores, predators);
+            }
+        }
+
+        std::unique_ptr<TrajectoryRecorder> recorder;
+        if (!options.recordPath.empty()) {
+            recorder = std::make_unique<TrajectoryRecorder>(options.recordPath, options.keyframeEvery);
+            recorder->record(ocean);
+        }
+
+        std::cout << "tick,algae,herbivores,predators\n";
+        printCounts(ocean);
+
+        auto start = std::chrono::steady_clock::now();
+        for (long long t = 1; t <= options.ticks; ++t) {
+            ocean.tick();
+            if (recorder) {
+                recorder->record(ocean);
+            }
+            if (options.reportEvery > 0 && t % options.reportEvery == 0) {
+                printCounts(ocean);
+            }
+            if (options.checkpointEvery > 0 && t % options.checkpointEvery == 0 && t != options.ticks) {
+                ocean.saveSnapshot(options.savePath);
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (options.reportEvery <= 0 || options.ticks % options.reportEvery != 0) {
+            printCounts(ocean);
+        }
+        if (!options.savePath.empty()) {
+            ocean.saveSnapshot(options.savePath);
+        }
+        if (recorder) {
+            recorder->close();
+        }
+        if (!options.statsPath.empty()) {
+            writeStats(ocean, options.statsPath);
+        }
+        if (!options.heatmapPath.empty()) {
+            writeHeatmap(ocean, options.heatmapPath, options.heatmapBlock);
+        }
+        std::cerr << options.ticks << " ticks in " << seconds << " s, "
+                  << options.ticks / seconds << " ticks/s, "
+                  << cells * options.ticks / seconds << " cells/s" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,15 +1,47 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <chrono>
 #include <thread>
+#include <random>
+#include <vector>
 
 #include <SDL.h>
 #include <SDL_ttf.h>
 
 #include "Ocean.h"
 #include "EntityType.h"
+#include "TripleBuffer.h"
 
 int main(int argc, char* args[]) {
+    // Аргументы: [seed] [--sim-thread] [--tick-ms N] [--boundary walls|torus|reflect].
+    // С --sim-thread такты считаются в отдельном потоке, а окно рисует последний готовый кадр;
+    // --tick-ms 0 снимает ограничение скорости симуляции.
+    std::uint64_t seed = std::random_device{}();
+    bool simulationThread = false;
+    float tickIntervalMs = 75.0f;
+    Boundary boundary = Boundary::Walls;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = args[i];
+            if (arg == "--sim-thread") {
+                simulationThread = true;
+            } else if (arg == "--tick-ms" && i + 1 < argc) {
+                tickIntervalMs = std::stof(args[++i]);
+            } else if (arg == "--boundary" && i + 1 < argc) {
+                boundary = parseBoundary(args[++i]);
+            } else {
+                seed = std::stoull(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Usage: " << args[0] << " [seed] [--sim-thread] [--tick-ms N] [--boundary walls|torus|reflect]" << std::endl;
+        return 1;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
         return 1;
@@ -78,14 +110,66 @@ int main(int argc, char* args[]) {
         return 1;
     }
 
-    Ocean ocean(oceanWidth, oceanHeight);
+    std::cout << "Seed: " << seed << std::endl;
+
+    Ocean ocean(oceanWidth, oceanHeight, seed, boundary);
     ocean.randomFill(oceanWidth * oceanHeight / 10,
                      oceanWidth * oceanHeight / 50,
                      oceanWidth * oceanHeight / 150);
 
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+    SDL_Texture* gridTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                                 oceanWidth, oceanHeight);
+    if (gridTexture == nullptr) {
+        std::cerr << "Grid texture could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        TTF_CloseFont(font);
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    // Поле рисуется как текстура с одним пикселем на клетку, растянутая одним SDL_RenderCopy.
+    // Цвета индексируются значением EntityType, формат ARGB8888.
+    const Uint32 palette[] = {
+        0xFF000046, // Sand
+        0xFF00FF00, // Algae
+        0xFF0000FF, // HerbivoreFish
+        0xFFFF0000, // PredatorFish
+    };
+    const SDL_Rect gridRect = {0, 0, oceanWidth * cellSize, oceanHeight * cellSize};
+    std::vector<EntityType> shownCells(static_cast<std::size_t>(oceanWidth) * oceanHeight, BORDER_CELL);
+    std::vector<Uint32> pixels(shownCells.size());
+    long long uploadedTick = -1;
+
+    // Кадры от потока симуляции передаются через тройной буфер: ни одна сторона не ждёт другую.
+    OceanFrame frame;
+    ocean.captureFrame(frame);
+    TripleBuffer<OceanFrame> frames(frame);
+    std::atomic<bool> simulating{true};
+    std::thread simulation;
+    if (simulationThread) {
+        simulation = std::thread([&] {
+            const auto interval = std::chrono::microseconds(static_cast<long long>(tickIntervalMs * 1000.0f));
+            auto nextTick = std::chrono::steady_clock::now();
+            while (simulating.load(std::memory_order_relaxed)) {
+                ocean.tick();
+                ocean.captureFrame(frames.writeSlot());
+                frames.publish();
+                if (interval.count() > 0) {
+                    nextTick += interval;
+                    std::this_thread::sleep_until(nextTick);
+                }
+            }
+        });
+    }
+
+    SDL_Texture* statsTexture = nullptr;
+    SDL_Rect statsRect = {10, windowHeight - 40, 0, 0};
+    std::string shownStats;
+
     Uint32 lastTickTime = SDL_GetTicks();
-    const float tickIntervalMs = 75.0f;
-    long long ticksCount = 0;
 
     bool quit = false;
     SDL_Event e;
@@ -101,62 +185,96 @@ int main(int argc, char* args[]) {
             }
         }
 
-        Uint32 currentTime = SDL_GetTicks();
-        if (currentTime - lastTickTime >= tickIntervalMs) {
-            ocean.tick();
-            ticksCount++;
-            lastTickTime = currentTime;
+        const OceanFrame* shown = &frame;
+        if (simulationThread) {
+            frames.acquire();
+            shown = &frames.readSlot();
+        } else {
+            Uint32 currentTime = SDL_GetTicks();
+            if (currentTime - lastTickTime >= tickIntervalMs) {
+                ocean.tick();
+                ocean.captureFrame(frame);
+                lastTickTime = currentTime;
+            }
         }
 
-        SDL_SetRenderDrawColor(renderer, 0, 0, 50, 255); 
-        SDL_RenderClear(renderer);
-
-        for (int y = 0; y < ocean.getHeight(); ++y) {
-            for (int x = 0; x < ocean.getWidth(); ++x) {
-                SDL_Rect cellRect = {x * cellSize, y * cellSize, cellSize, cellSize};
-
-                switch (ocean.getCellType(x, y)) {
-                    case EntityType::Sand:
-                        SDL_SetRenderDrawColor(renderer, 0, 0, 70, 255); 
-                        break;
-                    case EntityType::Algae:
-                        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); 
-                        break;
-                    case EntityType::HerbivoreFish:
-                        SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255); 
-                        break;
-                    case EntityType::PredatorFish:
-                        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); 
-                        break;
+        // В текстуру загружаются только строки, изменившиеся с прошлой загрузки,
+        // соседние изменённые строки — одним SDL_UpdateTexture.
+        if (uploadedTick != shown->tick) {
+            int dirtyBegin = -1;
+            for (int y = 0; y <= oceanHeight; ++y) {
+                bool dirty = false;
+                if (y < oceanHeight) {
+                    std::size_t offset = static_cast<std::size_t>(y) * oceanWidth;
+                    auto row = shown->cells.begin() + offset;
+                    if (!std::equal(row, row + oceanWidth, shownCells.begin() + offset)) {
+                        std::copy(row, row + oceanWidth, shownCells.begin() + offset);
+                        for (int x = 0; x < oceanWidth; ++x) {
+                            pixels[offset + x] = palette[static_cast<int>(row[x])];
+                        }
+                        dirty = true;
+                    }
+                }
+                if (dirty && dirtyBegin < 0) {
+                    dirtyBegin = y;
+                } else if (!dirty && dirtyBegin >= 0) {
+                    SDL_Rect rows = {0, dirtyBegin, oceanWidth, y - dirtyBegin};
+                    SDL_UpdateTexture(gridTexture, &rows, &pixels[static_cast<std::size_t>(dirtyBegin) * oceanWidth],
+                                      oceanWidth * static_cast<int>(sizeof(Uint32)));
+                    dirtyBegin = -1;
                 }
-                SDL_RenderFillRect(renderer, &cellRect);
             }
+            uploadedTick = shown->tick;
         }
 
-        std::string stats = "Tick: " + std::to_string(ticksCount) +
-                            "   Algae: " + std::to_string(ocean.countEntities(EntityType::Algae)) +
-                            "   Herbivores: " + std::to_string(ocean.countEntities(EntityType::HerbivoreFish)) +
-                            "   Predators: " + std::to_string(ocean.countEntities(EntityType::PredatorFish));
+        SDL_SetRenderDrawColor(renderer, 0, 0, 50, 255); 
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, gridTexture, nullptr, &gridRect);
 
-        SDL_Color textColor = {255, 255, 255, 255}; 
-        SDL_Surface* textSurface = TTF_RenderText_Solid(font, stats.c_str(), textColor);
-        if (textSurface == nullptr) {
-            std::cerr << "Unable to render text surface! TTF_Error: " << TTF_GetError() << std::endl;
-        } else {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            if (textTexture == nullptr) {
-                std::cerr << "Unable to create texture from rendered text! SDL_Error: " << SDL_GetError() << std::endl;
+        const EntityCounts& counts = shown->counts;
+        std::string stats = "Tick: " + std::to_string(shown->tick) +
+                            "   Algae: " + std::to_string(counts[static_cast<int>(EntityType::Algae)]) +
+                            "   Herbivores: " + std::to_string(counts[static_cast<int>(EntityType::HerbivoreFish)]) +
+                            "   Predators: " + std::to_string(counts[static_cast<int>(EntityType::PredatorFish)]);
+
+        // Текст статистики перерисовывается только когда меняются числа.
+        if (stats != shownStats) {
+            SDL_Color textColor = {255, 255, 255, 255}; 
+            SDL_Surface* textSurface = TTF_RenderText_Solid(font, stats.c_str(), textColor);
+            if (textSurface == nullptr) {
+                std::cerr << "Unable to render text surface! TTF_Error: " << TTF_GetError() << std::endl;
             } else {
-                SDL_Rect textRect = {10, windowHeight - 40, textSurface->w, textSurface->h}; 
-                SDL_RenderCopy(renderer, textTexture, nullptr, &textRect);
-                SDL_DestroyTexture(textTexture);
+                SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+                if (textTexture == nullptr) {
+                    std::cerr << "Unable to create texture from rendered text! SDL_Error: " << SDL_GetError() << std::endl;
+                } else {
+                    if (statsTexture != nullptr) {
+                        SDL_DestroyTexture(statsTexture);
+                    }
+                    statsTexture = textTexture;
+                    statsRect.w = textSurface->w;
+                    statsRect.h = textSurface->h;
+                    shownStats = stats;
+                }
+                SDL_FreeSurface(textSurface);
             }
-            SDL_FreeSurface(textSurface);
+        }
+        if (statsTexture != nullptr) {
+            SDL_RenderCopy(renderer, statsTexture, nullptr, &statsRect);
         }
 
         SDL_RenderPresent(renderer); 
     }
 
+    simulating = false;
+    if (simulation.joinable()) {
+        simulation.join();
+    }
+
+    if (statsTexture != nullptr) {
+        SDL_DestroyTexture(statsTexture);
+    }
+    SDL_DestroyTexture(gridTexture);
     TTF_CloseFont(font);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
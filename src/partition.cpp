@@ -0,0 +1,202 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "OceanPartition.h"
+#include "EntityType.h"
+
+namespace {
+
+struct Options {
+    int width = 80;
+    int height = 256;
+    double algae = 1.0 / 10;
+    double herbivores = 1.0 / 50;
+    double predators = 1.0 / 150;
+    std::uint64_t seed = 0;
+    std::string paramsPath;
+    long long ticks = 1000;
+    int threads = 1;
+    long long reportEvery = 0;
+    int ranks = 2;
+    int rank = -1;
+    std::string transport;
+    bool help = false;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --width N         grid width (80)\n"
+              << "  --height N        grid height (256)\n"
+              << "  --algae F         probability that a cell is seeded with algae (0.1)\n"
+              << "  --herbivores F    probability of a herbivore (0.02)\n"
+              << "  --predators F     probability of a predator (0.00667)\n"
+              << "  --seed N          random seed (0)\n"
+              << "  --params PATH     species parameters file (built-in defaults)\n"
+              << "  --ticks N         number of ticks to run (1000)\n"
+              << "  --threads N       worker threads per rank (1)\n"
+              << "  --report N        print populations every N ticks (0: only at the end)\n"
+              << "  --ranks N         number of strips the grid is split into (2)\n"
+              << "  --rank R          run only strip R and connect to the others over --transport;\n"
+              << "                    without it all ranks run as local processes over socket pairs\n"
+              << "  --transport SPEC  unix:PATH or tcp:PORT:HOST0,HOST1,... (one host per rank)\n";
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string name = argv[i];
+        if (name == "--help" || name == "-h") {
+            options.help = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("missing value for " + name);
+        }
+        std::string value = argv[++i];
+        if (name == "--width") options.width = std::stoi(value);
+        else if (name == "--height") options.height = std::stoi(value);
+        else if (name == "--algae") options.algae = std::stod(value);
+        else if (name == "--herbivores") options.herbivores = std::stod(value);
+        else if (name == "--predators") options.predators = std::stod(value);
+        else if (name == "--seed") options.seed = std::stoull(value);
+        else if (name == "--params") options.paramsPath = value;
+        else if (name == "--ticks") options.ticks = std::stoll(value);
+        else if (name == "--threads") options.threads = std::stoi(value);
+        else if (name == "--report") options.reportEvery = std::stoll(value);
+        else if (name == "--ranks") options.ranks = std::stoi(value);
+        else if (name == "--rank") options.rank = std::stoi(value);
+        else if (name == "--transport") options.transport = value;
+        else throw std::invalid_argument("unknown option " + name);
+    }
+    if ((options.rank >= 0) != !options.transport.empty()) {
+        throw std::invalid_argument("--rank and --transport go together");
+    }
+    // Проверяем разбиение до запуска процессов, чтобы ошибка была одна.
+    OceanPartition::ownedRows(options.height, 0, options.ranks);
+    return options;
+}
+
+void printCounts(long long tick, const EntityCounts& counts) {
+    std::cout << tick << ','
+              << counts[static_cast<int>(EntityType::Algae)] << ','
+              << counts[static_cast<int>(EntityType::HerbivoreFish)] << ','
+              << counts[static_cast<int>(EntityType::PredatorFish)] << '\n';
+}
+
+// Один раздел; печатает только раздел 0, но countAll вызывают все.
+int runRank(const Options& options, int rank, HaloTransport& transport) {
+    try {
+        OceanPartition partition(options.width, options.height, rank, options.ranks, transport, options.seed);
+        partition.setThreadCount(options.threads);
+        if (!options.paramsPath.empty()) {
+            partition.setSpeciesParams(loadEcosystemParams(options.paramsPath));
+        }
+        partition.randomFill(options.algae, options.herbivores, options.predators);
+
+        auto report = [&] {
+            EntityCounts counts = partition.countAll();
+            if (rank == 0) {
+                printCounts(partition.getTickCount(), counts);
+            }
+        };
+        if (rank == 0) {
+            std::cout << "tick,algae,herbivores,predators\n";
+        }
+        report();
+
+        auto start = std::chrono::steady_clock::now();
+        for (long long t = 1; t <= options.ticks; ++t) {
+            partition.tick();
+            if (options.reportEvery > 0 && t % options.reportEvery == 0) {
+                report();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (options.reportEvery <= 0 || options.ticks % options.reportEvery != 0) {
+            report();
+        }
+        if (rank == 0) {
+            double cells = static_cast<double>(options.width) * options.height;
+            std::cerr << options.ticks << " ticks on " << options.ranks << " ranks in " << seconds << " s, "
+                      << options.ticks / seconds << " ticks/s, "
+                      << cells * options.ticks / seconds << " cells/s" << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error (rank " << rank << "): " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Все разделы — дочерние процессы этой машины, соединённые парами сокетов.
+int runLocal(const Options& options) {
+    std::vector<std::unique_ptr<SocketTransport>> transports = SocketTransport::chain(options.ranks);
+    std::cout.flush();
+    std::vector<pid_t> children;
+    for (int rank = 0; rank < options.ranks; ++rank) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            std::cerr << "Error: cannot start rank " << rank << std::endl;
+            break;
+        }
+        if (pid == 0) {
+            // Чужие сокеты закрываем, иначе сосед не заметит, что раздел упал.
+            for (int other = 0; other < options.ranks; ++other) {
+                if (other != rank) transports[other].reset();
+            }
+            int status = runRank(options, rank, *transports[rank]);
+            std::cout.flush();
+            std::_Exit(status);
+        }
+        children.push_back(pid);
+    }
+    transports.clear();
+
+    int result = static_cast<int>(children.size()) == options.ranks ? 0 : 1;
+    for (pid_t pid : children) {
+        int status = 0;
+        if (::waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            result = 1;
+        }
+    }
+    return result;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.help) {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    if (options.transport.empty()) {
+        return runLocal(options);
+    }
+    std::unique_ptr<SocketTransport> transport;
+    try {
+        transport = SocketTransport::connect(options.transport, options.rank, options.ranks);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return runRank(options, options.rank, *transport);
+}
\ No newline at end of file
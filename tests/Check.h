@@ -0,0 +1,74 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include "IOcean.h"
+#include <iostream>
+
+// Проверки для тестов без сторонних библиотек. Проваленная проверка печатает
+// файл, строку и выражение и не прерывает тест; checkResult() — код возврата.
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void checkFailed(const char* file, int line, const char* expression) {
+    std::cerr << file << ':' << line << ": check failed: " << expression << std::endl;
+    ++checkFailures();
+}
+
+#define CHECK(condition)                                      \
+    do {                                                      \
+        if (!(condition)) {                                   \
+            checkFailed(__FILE__, __LINE__, #condition);      \
+        }                                                     \
+    } while (false)
+
+#define CHECK_THROWS(expression, Exception)                                       \
+    do {                                                                          \
+        bool thrown = false;                                                      \
+        try {                                                                     \
+            (void)(expression);                                                   \
+        } catch (const Exception&) {                                              \
+            thrown = true;                                                        \
+        }                                                                         \
+        if (!thrown) {                                                            \
+            checkFailed(__FILE__, __LINE__, #expression " throws " #Exception);   \
+        }                                                                         \
+    } while (false)
+
+inline int checkResult() {
+    if (checkFailures() != 0) {
+        std::cerr << checkFailures() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Совпадают ли два поля клетка в клетку вместе с возрастом и голодом.
+inline bool sameCells(const IOcean& a, const IOcean& b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight()) {
+        return false;
+    }
+    for (int y = 0; y < a.getHeight(); ++y) {
+        for (int x = 0; x < a.getWidth(); ++x) {
+            if (a.getCellType(x, y) != b.getCellType(x, y) || a.getAge(x, y) != b.getAge(x, y) ||
+                a.getHunger(x, y) != b.getHunger(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Численность видов, подсчитанная проходом по полю, для сверки со счётчиками.
+inline EntityCounts scanCounts(const IOcean& ocean) {
+    EntityCounts counts{};
+    for (int y = 0; y < ocean.getHeight(); ++y) {
+        for (int x = 0; x < ocean.getWidth(); ++x) {
+            ++counts[static_cast<std::size_t>(ocean.getCellType(x, y))];
+        }
+    }
+    return counts;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "Check.h"
+#include "BitPlanes.h"
+#include "EntityKernels.h"
+#include "Ocean.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+unsigned naiveMask(const Ocean& ocean, EntityType type, int x, int y) {
+    unsigned mask = 0;
+    for (int k = 0; k < 8; ++k) {
+        int nx = x + NEIGHBOUR_DX[k], ny = y + NEIGHBOUR_DY[k];
+        if (ocean.inBounds(nx, ny) && ocean.getCellType(nx, ny) == type) {
+            mask |= 1u << k;
+        }
+    }
+    return mask;
+}
+
+// Ширина не кратна 64, чтобы проверить последнее неполное слово и рамку.
+void testPlanesMatchGrid() {
+    Ocean ocean(200, 37, 6);
+    ocean.randomFill(2000, 700, 300);
+    ocean.tick();
+    BitPlanes planes;
+    ocean.packPlanes(planes);
+    CHECK(planes.getWidth() == 200 && planes.getHeight() == 37);
+
+    bool cells = true, masks = true;
+    for (int y = 0; y < 37; ++y) {
+        for (int x = 0; x < 200; ++x) {
+            for (EntityType type : {EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+                cells = cells && planes.test(type, x, y) == (ocean.getCellType(x, y) == type);
+                masks = masks && planes.neighbourMask(type, x, y) == naiveMask(ocean, type, x, y);
+            }
+        }
+    }
+    CHECK(cells);
+    CHECK(masks);
+}
+
+// Все уровни SIMD дают те же счётчики, что и прямой подсчёт.
+void testNeighbourCountsEveryLevel() {
+    Ocean ocean(131, 29, 9);
+    ocean.randomFill(1200, 400, 200);
+    BitPlanes planes;
+    ocean.packPlanes(planes);
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2}) {
+        for (EntityType type : {EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+            NeighbourCounts counts;
+            countNeighbours(planes, type, counts, level);
+            std::vector<std::uint8_t> bytes;
+            counts.toBytes(bytes);
+            bool same = bytes.size() == 131u * 29u;
+            for (int y = 0; same && y < 29; ++y) {
+                for (int x = 0; x < 131; ++x) {
+                    int expected = countBits(naiveMask(ocean, type, x, y));
+                    same = same && counts.at(x, y) == expected &&
+                           bytes[static_cast<std::size_t>(y) * 131 + x] == expected;
+                }
+            }
+            CHECK(same);
+        }
+    }
+}
+
+}
+
+int main() {
+    testPlanesMatchGrid();
+    testNeighbourCountsEveryLevel();
+    return checkResult();
+}
\ No newline at end of file
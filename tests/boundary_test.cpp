@@ -0,0 +1,85 @@
+#include "Check.h"
+#include "Boundary.h"
+#include "Ocean.h"
+
+#include <stdexcept>
+
+namespace {
+
+// Координата за краем на одну-две клетки возвращается в поле.
+void testPolicies() {
+    CHECK(TorusBoundary::map(-1, 5) == 4 && TorusBoundary::map(-2, 5) == 3);
+    CHECK(TorusBoundary::map(5, 5) == 0 && TorusBoundary::map(6, 5) == 1);
+    CHECK(TorusBoundary::map(2, 5) == 2);
+    CHECK(ReflectBoundary::map(-1, 5) == 1 && ReflectBoundary::map(-2, 5) == 2);
+    CHECK(ReflectBoundary::map(5, 5) == 3 && ReflectBoundary::map(6, 5) == 2);
+    CHECK(ReflectBoundary::map(0, 5) == 0 && ReflectBoundary::map(4, 5) == 4);
+
+    CHECK(parseBoundary("walls") == Boundary::Walls);
+    CHECK(parseBoundary("torus") == Boundary::Torus);
+    CHECK(parseBoundary("reflect") == Boundary::Reflect);
+    CHECK_THROWS(parseBoundary("sphere"), std::invalid_argument);
+}
+
+// На торе травоядное у левого края видит водоросль у правого, за стеной — нет.
+void testTorusWraps() {
+    for (Boundary boundary : {Boundary::Walls, Boundary::Torus}) {
+        Ocean ocean(10, 10, 1, boundary);
+        ocean.setCell(0, 5, EntityType::HerbivoreFish);
+        ocean.setCell(9, 5, EntityType::Algae);
+        ocean.tick();
+        if (boundary == Boundary::Torus) {
+            CHECK(ocean.getCellType(9, 5) == EntityType::HerbivoreFish);
+            CHECK(ocean.getCellType(0, 5) == EntityType::Sand);
+        } else {
+            CHECK(ocean.getCellType(9, 5) == EntityType::Algae);
+        }
+        CHECK(ocean.getBoundary() == boundary);
+    }
+}
+
+// Заворачивающей границе нужно поле хотя бы 3x3; стены работают на любом.
+void testSmallGrids() {
+    CHECK_THROWS(Ocean(2, 5, 0, Boundary::Torus), std::invalid_argument);
+    CHECK_THROWS(Ocean(5, 2, 0, Boundary::Reflect), std::invalid_argument);
+    for (Boundary boundary : {Boundary::Walls, Boundary::Torus, Boundary::Reflect}) {
+        Ocean ocean(3, 3, 5, boundary);
+        ocean.randomFill(3, 2, 1);
+        for (int i = 0; i < 30; ++i) {
+            ocean.tick();
+        }
+        CHECK(ocean.countAllEntities() == scanCounts(ocean));
+    }
+    Ocean line(1, 7, 5);
+    line.randomFill(2, 1, 1);
+    line.tick();
+    CHECK(line.countAllEntities() == scanCounts(line));
+}
+
+// При любой границе результат не зависит от числа потоков, а счётчики
+// совпадают с полем. Размеры не кратны плитке, чтобы край попал внутрь плиток.
+void testThreadsAgree() {
+    for (Boundary boundary : {Boundary::Walls, Boundary::Torus, Boundary::Reflect}) {
+        Ocean single(193, 70, 7, boundary);
+        Ocean threaded(193, 70, 7, boundary);
+        threaded.setThreadCount(4);
+        single.randomFill(3000, 1000, 400);
+        threaded.randomFill(3000, 1000, 400);
+        for (int i = 0; i < 40; ++i) {
+            single.tick();
+            threaded.tick();
+        }
+        CHECK(sameCells(single, threaded));
+        CHECK(threaded.countAllEntities() == scanCounts(threaded));
+    }
+}
+
+}
+
+int main() {
+    testPolicies();
+    testTorusWraps();
+    testSmallGrids();
+    testThreadsAgree();
+    return checkResult();
+}
\ No newline at end of file
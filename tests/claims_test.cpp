@@ -0,0 +1,138 @@
+#include "Check.h"
+#include "Ocean.h"
+
+#include <set>
+#include <utility>
+
+namespace {
+
+// Четыре травоядных окружают одну водоросль: съедает её ровно одно, а
+// остальные гибнут в драке за неё. Победитель зависит от зерна, а не от
+// порядка обхода.
+void testContestedPrey() {
+    const std::pair<int, int> sides[4] = {{2, 3}, {4, 3}, {3, 2}, {3, 4}};
+    std::set<int> winners;
+    for (std::uint64_t seed = 0; seed < 32; ++seed) {
+        Ocean ocean(7, 7, seed);
+        ocean.setCell(3, 3, EntityType::Algae);
+        // По возрасту видно, с какой стороны пришёл победитель.
+        for (int k = 0; k < 4; ++k) {
+            ocean.setCell(sides[k].first, sides[k].second, EntityType::HerbivoreFish, k, 0);
+        }
+        ocean.tick();
+        CHECK(ocean.getCellType(3, 3) == EntityType::HerbivoreFish);
+        CHECK(ocean.getHunger(3, 3) == 0);
+        CHECK(ocean.countEntities(EntityType::HerbivoreFish) == 1);
+        CHECK(ocean.countEntities(EntityType::Algae) == 0);
+        for (int k = 0; k < 4; ++k) {
+            CHECK(ocean.getCellType(sides[k].first, sides[k].second) == EntityType::Sand);
+        }
+        winners.insert(ocean.getAge(3, 3) - 1);
+    }
+    CHECK(winners.size() >= 3);
+}
+
+// Хищник берёт травоядное, только если опережает его: тогда съеденное не
+// успевает ни уплыть, ни съесть свою водоросль. Иначе травоядное уходит к
+// водоросли, а хищник остаётся на месте. При разных зёрнах бывает и то, и другое.
+void testPreyCanEscape() {
+    int caught = 0;
+    int escaped = 0;
+    for (std::uint64_t seed = 0; seed < 32; ++seed) {
+        Ocean ocean(5, 1, seed);
+        ocean.setCell(0, 0, EntityType::PredatorFish);
+        ocean.setCell(1, 0, EntityType::HerbivoreFish);
+        ocean.setCell(2, 0, EntityType::Algae);
+        ocean.tick();
+        if (ocean.getCellType(1, 0) == EntityType::PredatorFish) {
+            ++caught;
+            CHECK(ocean.getCellType(0, 0) == EntityType::Sand);
+            CHECK(ocean.countEntities(EntityType::HerbivoreFish) == 0);
+            CHECK(ocean.getCellType(2, 0) == EntityType::Algae);
+        } else {
+            ++escaped;
+            CHECK(ocean.getCellType(0, 0) == EntityType::PredatorFish);
+            CHECK(ocean.getHunger(0, 0) == 1);
+            CHECK(ocean.getCellType(1, 0) == EntityType::Sand);
+            CHECK(ocean.getCellType(2, 0) == EntityType::HerbivoreFish);
+            CHECK(ocean.countEntities(EntityType::Algae) == 0);
+        }
+    }
+    CHECK(caught > 0 && escaped > 0);
+}
+
+// Малёк появляется рядом с новой клеткой родителя: в ряду из пяти клеток
+// у старой клетки нет другого песка, кроме цели хода.
+void testChildNextToNewCell() {
+    for (EntityType fish : {EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+        int adult = fish == EntityType::HerbivoreFish ? 10 : 15;
+        Ocean ocean(5, 1, 3);
+        ocean.setCell(0, 0, fish, adult - 1, 0);
+        ocean.tick();
+        CHECK(ocean.getCellType(0, 0) == EntityType::Sand);
+        CHECK(ocean.getCellType(1, 0) == fish);
+        CHECK(ocean.getAge(1, 0) == adult);
+        CHECK(ocean.getCellType(2, 0) == fish);
+        CHECK(ocean.getAge(2, 0) == 0);
+    }
+}
+
+// На тесном поле рыбы без еды и потомства только плавают и спорят за клетки:
+// ни одна не теряется и не раздваивается, при любом числе потоков.
+void testMovesConserveFish() {
+    EcosystemParams params;
+    params[EntityType::HerbivoreFish].reproduceAge = 1000;
+    params[EntityType::HerbivoreFish].maxAge = 1000;
+    params[EntityType::HerbivoreFish].maxHunger = 1000;
+    for (int threads : {1, 4}) {
+        Ocean ocean(150, 140, 21, Boundary::Torus);
+        ocean.setThreadCount(threads);
+        ocean.setSpeciesParams(params);
+        ocean.randomFill(0, 150 * 140 / 2, 0);
+        for (int t = 0; t < 50; ++t) {
+            ocean.tick();
+            CHECK(ocean.countEntities(EntityType::HerbivoreFish) == 150 * 140 / 2);
+        }
+        int found = 0;
+        for (int y = 0; y < 140; ++y) {
+            for (int x = 0; x < 150; ++x) {
+                found += ocean.getCellType(x, y) == EntityType::HerbivoreFish;
+            }
+        }
+        CHECK(found == 150 * 140 / 2);
+    }
+}
+
+// Тот же мир с тем же зерном приходит к тому же состоянию, а другое зерно —
+// к другому.
+void testSeedDecides() {
+    Ocean a(90, 60, 5);
+    Ocean b(90, 60, 5);
+    Ocean c(90, 60, 6);
+    for (Ocean* ocean : {&a, &b, &c}) {
+        for (int y = 0; y < 60; ++y) {
+            for (int x = 0; x < 90; ++x) {
+                int pattern = (x * 7 + y * 13) % 11;
+                ocean->setCell(x, y, pattern < 3 ? EntityType::Algae
+                                     : pattern == 3 ? EntityType::HerbivoreFish
+                                     : pattern == 4 && x % 3 == 0 ? EntityType::PredatorFish : EntityType::Sand);
+            }
+        }
+        for (int t = 0; t < 30; ++t) {
+            ocean->tick();
+        }
+    }
+    CHECK(sameCells(a, b));
+    CHECK(!sameCells(a, c));
+}
+
+}
+
+int main() {
+    testContestedPrey();
+    testPreyCanEscape();
+    testChildNextToNewCell();
+    testMovesConserveFish();
+    testSeedDecides();
+    return checkResult();
+}
\ No newline at end of file
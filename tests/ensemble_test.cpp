@@ -0,0 +1,120 @@
+#include "Check.h"
+#include "Ensemble.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::vector<EnsembleMember> sweep() {
+    std::vector<EnsembleMember> members;
+    for (int i = 0; i < 9; ++i) {
+        EnsembleMember member;
+        member.seed = 100 + static_cast<std::uint64_t>(i);
+        member.width = 40 + 7 * i;
+        member.herbivores = 0.01 + 0.005 * i;
+        member.predators = i == 0 ? 0 : 0.004;
+        member.boundary = i % 3 == 0 ? Boundary::Torus : Boundary::Walls;
+        members.push_back(member);
+    }
+    return members;
+}
+
+std::vector<EnsembleRow> runSweep(Ensemble& ensemble, int threads, int batch) {
+    std::vector<EnsembleRow> rows;
+    ensemble.run(50, threads, batch, [&](const EnsembleRow& row) { rows.push_back(row); });
+    return rows;
+}
+
+bool sameRows(const std::vector<EnsembleRow>& a, const std::vector<EnsembleRow>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].tick != b[i].tick || a[i].mean != b[i].mean || a[i].variance != b[i].variance ||
+            a[i].extinct != b[i].extinct) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Сводка и участники не зависят от числа потоков и размера пачки.
+void testThreadsAndBatches() {
+    Ensemble single(sweep());
+    Ensemble threaded(sweep());
+    std::vector<EnsembleRow> expected = runSweep(single, 1, 50);
+    std::vector<EnsembleRow> rows = runSweep(threaded, 4, 7);
+    CHECK(expected.size() == 51);
+    CHECK(expected.front().tick == 0 && expected.back().tick == 50);
+    CHECK(sameRows(expected, rows));
+    for (int i = 0; i < single.size(); ++i) {
+        CHECK(sameCells(single.member(i), threaded.member(i)));
+        for (EntityType species : {EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+            CHECK(single.extinctionTick(i, species) == threaded.extinctionTick(i, species));
+        }
+    }
+}
+
+// Среднее и дисперсия последней строки совпадают с подсчётом по участникам.
+void testAggregates() {
+    Ensemble ensemble(sweep());
+    std::vector<EnsembleRow> rows = runSweep(ensemble, 3, 16);
+    const EnsembleRow& last = rows.back();
+    for (std::size_t type = 0; type < 4; ++type) {
+        double sum = 0;
+        for (int i = 0; i < ensemble.size(); ++i) {
+            sum += static_cast<double>(ensemble.member(i).countAllEntities()[type]);
+        }
+        double mean = sum / ensemble.size();
+        double squares = 0;
+        for (int i = 0; i < ensemble.size(); ++i) {
+            double deviation = static_cast<double>(ensemble.member(i).countAllEntities()[type]) - mean;
+            squares += deviation * deviation;
+        }
+        CHECK(std::fabs(last.mean[type] - mean) < 1e-9 * (1 + mean));
+        CHECK(std::fabs(last.variance[type] - squares / (ensemble.size() - 1)) < 1e-9 * (1 + squares));
+    }
+    // У первого участника хищников не было с самого начала.
+    CHECK(ensemble.extinctionTick(0, EntityType::PredatorFish) == 0);
+    ExtinctionSummary summary = ensemble.extinctionSummary(EntityType::PredatorFish);
+    CHECK(summary.extinct >= 1 && summary.firstTick == 0);
+    CHECK(last.extinct[static_cast<std::size_t>(EntityType::PredatorFish)] == summary.extinct);
+}
+
+// Мир по умолчанию (80x40, доли 1/10, 1/50 и 1/150) почти всегда живёт
+// дольше 600 тактов: если правила такта нарушают равновесие, рыбы
+// вымирают почти у всех участников.
+void testDefaultWorldSurvives() {
+    std::vector<EnsembleMember> members(32);
+    for (std::size_t i = 0; i < members.size(); ++i) {
+        members[i].seed = i;
+    }
+    Ensemble ensemble(members);
+    ensemble.run(600, 2, 32, nullptr);
+    for (EntityType species : {EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+        CHECK(ensemble.extinctionSummary(species).extinct <= 4);
+    }
+}
+
+void testRejectsBadInput() {
+    CHECK_THROWS(Ensemble(std::vector<EnsembleMember>{}), std::invalid_argument);
+    std::vector<EnsembleMember> members(1);
+    members[0].algae = 0.9;
+    members[0].herbivores = 0.2;
+    CHECK_THROWS(Ensemble(members), std::invalid_argument);
+    Ensemble ensemble(sweep());
+    CHECK_THROWS(ensemble.run(10, 0, 5, nullptr), std::invalid_argument);
+    CHECK_THROWS(ensemble.run(10, 2, 0, nullptr), std::invalid_argument);
+}
+
+}
+
+int main() {
+    testThreadsAndBatches();
+    testAggregates();
+    testDefaultWorldSurvives();
+    testRejectsBadInput();
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "Check.h"
+#include "Ocean.h"
+#include "Seeding.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+bool placed(const Ocean& ocean, long long algae, long long herbivores, long long predators) {
+    EntityCounts counts = scanCounts(ocean);
+    long long cells = static_cast<long long>(ocean.getWidth()) * ocean.getHeight();
+    return counts == ocean.countAllEntities() && counts[1] == algae && counts[2] == herbivores &&
+           counts[3] == predators && counts[0] == cells - algae - herbivores - predators;
+}
+
+// Ставится ровно заданное число существ и при редком, и при плотном
+// заполнении, в том числе поверх уже занятых клеток.
+void testExactCounts() {
+    Ocean sparse(300, 200, 1);
+    sparse.randomFill(3000, 500, 100);
+    CHECK(placed(sparse, 3000, 500, 100));
+    Ocean dense(300, 200, 2);
+    dense.randomFill(40000, 15000, 4999);
+    CHECK(placed(dense, 40000, 15000, 4999));
+    dense.randomFill(0, 1, 0);
+    CHECK(placed(dense, 40000, 15001, 4999));
+
+    // Половина поля занята: даже небольшое добавление не уходит в бесконечные пробы.
+    Ocean half(200, 200, 3);
+    half.randomFill(20000, 0, 0);
+    half.randomFill(100, 4000, 10);
+    CHECK(placed(half, 20100, 4000, 10));
+
+    Ocean full(30, 30, 4);
+    full.randomFill(600, 200, 100);
+    CHECK(placed(full, 600, 200, 100));
+}
+
+// Одинаковое зерно даёт одинаковую расстановку.
+void testRepeatable() {
+    Ocean a(120, 80, 9);
+    Ocean b(120, 80, 9);
+    a.randomFill(2000, 300, 50);
+    b.randomFill(2000, 300, 50);
+    CHECK(sameCells(a, b));
+    a.randomFill(5000, 0, 0);
+    b.randomFill(5000, 0, 0);
+    CHECK(sameCells(a, b));
+}
+
+// Не поместившиеся существа отвергаются до того, как поле изменится.
+void testTooManyLeavesGrid() {
+    Ocean ocean(20, 10, 5);
+    ocean.randomFill(150, 20, 5);
+    Ocean before = ocean;
+    CHECK_THROWS(ocean.randomFill(20, 5, 1), std::invalid_argument);
+    CHECK(sameCells(ocean, before));
+    CHECK(ocean.countAllEntities() == before.countAllEntities());
+    CHECK_THROWS(ocean.randomFill(-1, 0, 0), std::invalid_argument);
+
+    std::vector<float> density(200, 0.0f);
+    for (int x = 0; x < 20; ++x) {
+        density[static_cast<std::size_t>(x)] = 1.0f;
+    }
+    CHECK_THROWS(ocean.randomFill(100, 0, 0, density), std::invalid_argument);
+    CHECK(sameCells(ocean, before));
+    density[5] = -1.0f;
+    CHECK_THROWS(ocean.randomFill(1, 0, 0, density), std::invalid_argument);
+    CHECK_THROWS(ocean.randomFill(1, 0, 0, std::vector<float>(199, 1.0f)), std::invalid_argument);
+    CHECK(sameCells(ocean, before));
+}
+
+// Клетки с нулевым весом остаются пустыми, сколько бы существ ни ставилось.
+void testZeroDensityStaysEmpty() {
+    const int width = 64, height = 48;
+    std::vector<float> density(static_cast<std::size_t>(width) * height, 0.0f);
+    long long open = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if ((x / 8 + y / 8) % 2 == 0) {
+                density[static_cast<std::size_t>(y) * width + x] = 1.0f + static_cast<float>(x % 3);
+                ++open;
+            }
+        }
+    }
+    Ocean ocean(width, height, 6);
+    ocean.randomFill(static_cast<int>(open) - 10, 5, 5, density);
+    CHECK(placed(ocean, open - 10, 5, 5));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (density[static_cast<std::size_t>(y) * width + x] == 0) {
+                CHECK(ocean.getCellType(x, y) == EntityType::Sand);
+            }
+        }
+    }
+
+    std::vector<float> clusters = clusterDensity(width, height, 3, 4.0, 7);
+    CHECK(clusters.size() == density.size());
+    Ocean clustered(width, height, 7);
+    clustered.randomFill(200, 20, 5, clusters);
+    CHECK(placed(clustered, 200, 20, 5));
+}
+
+// Карта из PGM растягивается на поле по ближайшему пикселю.
+void testDensityMapFile() {
+    {
+        std::ofstream out("fill_test.pgm");
+        out << "P2\n2 1\n255\n0 200\n";
+    }
+    std::vector<float> density = loadDensityMap("fill_test.pgm", 6, 3);
+    CHECK(density.size() == 18);
+    CHECK(density[0] == 0 && density[2] == 0 && density[3] > 0 && density[17] > 0);
+    {
+        std::ofstream out("fill_test.pgm");
+        out << "P7\n";
+    }
+    CHECK_THROWS(loadDensityMap("fill_test.pgm", 6, 3), std::runtime_error);
+    std::remove("fill_test.pgm");
+}
+
+}
+
+int main() {
+    testExactCounts();
+    testRepeatable();
+    testTooManyLeavesGrid();
+    testZeroDensityStaysEmpty();
+    testDensityMapFile();
+    return checkResult();
+}
\ No newline at end of file
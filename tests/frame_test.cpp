@@ -0,0 +1,76 @@
+#include "Check.h"
+#include "Ocean.h"
+#include "TripleBuffer.h"
+
+#include <thread>
+
+namespace {
+
+void testLatestValueWins() {
+    TripleBuffer<int> buffer(0);
+    CHECK(!buffer.acquire());
+    buffer.writeSlot() = 1;
+    buffer.publish();
+    buffer.writeSlot() = 2;
+    buffer.publish();
+    CHECK(buffer.acquire());
+    CHECK(buffer.readSlot() == 2);
+    CHECK(!buffer.acquire());
+    CHECK(buffer.readSlot() == 2);
+}
+
+// Писатель и читатель в разных потоках: читатель видит только целые значения
+// и только в порядке публикации, последнее — обязательно.
+void testConcurrentHandoff() {
+    struct Pair {
+        long long a = 0;
+        long long b = 0;
+    };
+    constexpr long long LAST = 200000;
+    TripleBuffer<Pair> buffer;
+    std::thread writer([&] {
+        for (long long i = 1; i <= LAST; ++i) {
+            buffer.writeSlot() = {i, -i};
+            buffer.publish();
+        }
+    });
+    long long seen = 0;
+    bool torn = false, backwards = false;
+    while (seen < LAST) {
+        if (buffer.acquire()) {
+            const Pair& value = buffer.readSlot();
+            torn = torn || value.a != -value.b;
+            backwards = backwards || value.a <= seen;
+            seen = value.a;
+        }
+    }
+    writer.join();
+    CHECK(!torn);
+    CHECK(!backwards);
+}
+
+void testCaptureFrame() {
+    Ocean ocean(37, 21, 2);
+    ocean.randomFill(100, 20, 5);
+    ocean.tick();
+    OceanFrame frame;
+    ocean.captureFrame(frame);
+    CHECK(frame.width == 37 && frame.height == 21 && frame.tick == 1);
+    CHECK(frame.counts == ocean.countAllEntities());
+    bool same = frame.cells.size() == 37u * 21u;
+    for (int y = 0; same && y < 21; ++y) {
+        for (int x = 0; x < 37; ++x) {
+            same = same && frame.cells[static_cast<std::size_t>(y) * 37 + x] == ocean.getCellType(x, y);
+        }
+    }
+    CHECK(same);
+}
+
+}
+
+int main() {
+    testLatestValueWins();
+    testConcurrentHandoff();
+    testCaptureFrame();
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "Check.h"
+#include "Algae.h"
+#include "EntityKernels.h"
+#include "HerbivoreFish.h"
+#include "Ocean.h"
+#include "PredatorFish.h"
+
+namespace {
+
+// Водоросль без соседей доживает до MAX_AGE и на следующем такте исчезает.
+void testAlgaeDiesOfAge() {
+    Ocean ocean(1, 1);
+    ocean.setCell(0, 0, EntityType::Algae);
+    for (int t = 0; t < Algae::MAX_AGE; ++t) {
+        ocean.tick();
+    }
+    CHECK(ocean.getCellType(0, 0) == EntityType::Algae);
+    CHECK(ocean.getAge(0, 0) == Algae::MAX_AGE);
+    ocean.tick();
+    CHECK(ocean.getCellType(0, 0) == EntityType::Sand);
+}
+
+void testPredatorStarves() {
+    Ocean ocean(1, 1);
+    ocean.setCell(0, 0, EntityType::PredatorFish);
+    for (int t = 0; t < PredatorFish::MAX_HUNGER; ++t) {
+        ocean.tick();
+    }
+    CHECK(ocean.getHunger(0, 0) == PredatorFish::MAX_HUNGER);
+    ocean.tick();
+    CHECK(ocean.getCellType(0, 0) == EntityType::Sand);
+}
+
+void testHerbivoreEats() {
+    Ocean ocean(2, 1);
+    ocean.setCell(0, 0, EntityType::HerbivoreFish, 1, 8);
+    ocean.setCell(1, 0, EntityType::Algae);
+    ocean.tick();
+    CHECK(ocean.getCellType(0, 0) == EntityType::Sand);
+    CHECK(ocean.getCellType(1, 0) == EntityType::HerbivoreFish);
+    CHECK(ocean.getHunger(1, 0) == 9 - HerbivoreFish::HUNGER_DECREASE);
+    CHECK(ocean.countEntities(EntityType::Algae) == 0);
+}
+
+// Обёртки Entity идут через те же ядра, что и Ocean.
+void testEntityWrappersUseKernels() {
+    Ocean current(2, 1);
+    current.setCell(0, 0, EntityType::PredatorFish, 2, 10);
+    current.setCell(1, 0, EntityType::HerbivoreFish);
+    Ocean next = current;
+    PredatorFish predator;
+    predator.tick(0, 0, current, next);
+    CHECK(next.getCellType(0, 0) == EntityType::Sand);
+    CHECK(next.getCellType(1, 0) == EntityType::PredatorFish);
+    CHECK(next.getAge(1, 0) == 3);
+    CHECK(next.getHunger(1, 0) == 11 - PredatorFish::HUNGER_DECREASE);
+
+    Ocean old(1, 1);
+    old.setCell(0, 0, EntityType::Algae, Algae::MAX_AGE, 0);
+    Ocean after = old;
+    Algae algae;
+    algae.tick(0, 0, old, after);
+    CHECK(after.getCellType(0, 0) == EntityType::Sand);
+}
+
+
+// Соседи выбираются по 8-битной маске без временных массивов.
+void testNeighbourMasks() {
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        int bits = 0;
+        for (int k = 0; k < 8; ++k) {
+            bits += (mask >> k) & 1u;
+        }
+        CHECK(countBits(mask) == bits);
+        for (int k = 0, seen = 0; k < 8; ++k) {
+            if ((mask >> k) & 1u) {
+                CHECK(selectBit(mask, static_cast<unsigned>(seen++)) == k);
+            }
+        }
+    }
+
+    CounterRandom gen(CounterRandom::key(3, 0), 0);
+    unsigned mask = 0xA5;
+    unsigned hit = 0;
+    for (int i = 0; i < 200; ++i) {
+        int k = pickBit(mask, gen);
+        CHECK((mask >> k) & 1u);
+        hit |= 1u << k;
+    }
+    CHECK(hit == mask);
+
+    // За краем поля — BORDER_CELL, а не песок.
+    Ocean ocean(3, 3);
+    ocean.setCell(1, 0, EntityType::Algae);
+    Neighbourhood corner = scanNeighbourhood(0, 0, ReadableOceanRef(ocean), EntityType::Algae);
+    CHECK(countBits(corner.sand) == 2);
+    CHECK(countBits(corner.prey) == 1);
+}
+}
+
+int main() {
+    testAlgaeDiesOfAge();
+    testPredatorStarves();
+    testHerbivoreEats();
+    testEntityWrappersUseKernels();
+    testNeighbourMasks();
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "Check.h"
+#include "BitPlanes.h"
+#include "GridLayout.h"
+#include "Ocean.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const char* const SNAPSHOT_PATH = "layout_test.snap";
+// Смещение поля layout в заголовке снимка, см. SnapshotHeader в OceanSnapshot.cpp.
+constexpr std::size_t LAYOUT_OFFSET = 192;
+
+const GridLayout LAYOUTS[3] = {GridLayout::Linear, GridLayout::Tiled, GridLayout::Morton};
+
+// Раскладка не меняет ни результат тактов, ни ответы запросов. Размеры
+// захватывают неполные блоки 64x64 и поля уже одного блока.
+void testLayoutsAgree() {
+    const std::pair<int, int> sizes[] = {{257, 130}, {65, 127}, {64, 64}, {3, 3}, {200, 1}};
+    for (Boundary boundary : {Boundary::Walls, Boundary::Torus, Boundary::Reflect}) {
+        for (auto [width, height] : sizes) {
+            if (boundary != Boundary::Walls && height < 3) {
+                continue;
+            }
+            Ocean linear(width, height, 7, boundary, GridLayout::Linear);
+            linear.randomFill(width * height / 4, width * height / 12, width * height / 30);
+            for (int t = 0; t < 40; ++t) {
+                linear.tick();
+            }
+            for (GridLayout layout : {GridLayout::Tiled, GridLayout::Morton}) {
+                Ocean other(width, height, 7, boundary, layout);
+                CHECK(other.getLayout() == layout);
+                other.setThreadCount(3);
+                other.randomFill(width * height / 4, width * height / 12, width * height / 30);
+                for (int t = 0; t < 40; ++t) {
+                    other.tick();
+                }
+                CHECK(sameCells(linear, other));
+                CHECK(other.countAllEntities() == linear.countAllEntities());
+                CHECK(other.countInRect(EntityType::Algae, width / 3, height / 3, width / 2 + 1, height / 2 + 1) ==
+                      linear.countInRect(EntityType::Algae, width / 3, height / 3, width / 2 + 1, height / 2 + 1));
+            }
+        }
+    }
+}
+
+// Построчные выгрузки отдают поле по порядку при любой раскладке.
+void testRowAccess() {
+    for (GridLayout layout : LAYOUTS) {
+        Ocean ocean(130, 70, 3, Boundary::Walls, layout);
+        ocean.randomFill(2000, 500, 100);
+        ocean.tick();
+        std::vector<EntityType> row(130);
+        ocean.copyRow(69, row.data());
+        OceanFrame frame;
+        ocean.captureFrame(frame);
+        BitPlanes planes;
+        ocean.packPlanes(planes);
+        int mismatches = 0;
+        for (int x = 0; x < 130; ++x) {
+            mismatches += row[static_cast<std::size_t>(x)] != ocean.getCellType(x, 69);
+        }
+        for (int y = 0; y < 70; ++y) {
+            for (int x = 0; x < 130; ++x) {
+                EntityType type = ocean.getCellType(x, y);
+                mismatches += frame.cells[static_cast<std::size_t>(y) * 130 + x] != type;
+                mismatches += type != EntityType::Sand && !planes.test(type, x, y);
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+// Снимок помнит раскладку, продолжение совпадает с непрерывным прогоном,
+// а неизвестная раскладка в заголовке отвергается.
+void testSnapshotKeepsLayout() {
+    for (GridLayout layout : LAYOUTS) {
+        Ocean ocean(100, 90, 4, Boundary::Torus, layout);
+        ocean.randomFill(2000, 400, 100);
+        for (int t = 0; t < 10; ++t) {
+            ocean.tick();
+        }
+        ocean.saveSnapshot(SNAPSHOT_PATH);
+        Ocean loaded = Ocean::loadSnapshot(SNAPSHOT_PATH);
+        CHECK(loaded.getLayout() == layout);
+        CHECK(sameCells(loaded, ocean));
+        for (int t = 0; t < 10; ++t) {
+            ocean.tick();
+            loaded.tick();
+        }
+        CHECK(sameCells(loaded, ocean));
+    }
+
+    std::vector<char> bytes;
+    {
+        std::ifstream in(SNAPSHOT_PATH, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::uint32_t layout;
+    std::memcpy(&layout, bytes.data() + LAYOUT_OFFSET, sizeof(layout));
+    CHECK(layout == static_cast<std::uint32_t>(GridLayout::Morton));
+    layout = 7;
+    std::memcpy(bytes.data() + LAYOUT_OFFSET, &layout, sizeof(layout));
+    {
+        std::ofstream out(SNAPSHOT_PATH, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    CHECK_THROWS(Ocean::loadSnapshot(SNAPSHOT_PATH), std::runtime_error);
+}
+
+void testParse() {
+    CHECK(parseGridLayout("linear") == GridLayout::Linear);
+    CHECK(parseGridLayout("tiled") == GridLayout::Tiled);
+    CHECK(parseGridLayout("morton") == GridLayout::Morton);
+    CHECK_THROWS(parseGridLayout("hilbert"), std::invalid_argument);
+    CHECK_THROWS(Ocean(10, 10, 0, Boundary::Walls, static_cast<GridLayout>(9)), std::invalid_argument);
+}
+
+}
+
+int main() {
+    testLayoutsAgree();
+    testRowAccess();
+    testSnapshotKeepsLayout();
+    testParse();
+    std::remove(SNAPSHOT_PATH);
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "Check.h"
+#include "HerbivoreFish.h"
+#include "Ocean.h"
+
+#include <stdexcept>
+
+namespace {
+
+// Поле — один буфер с рамкой: за краем читать и писать нельзя.
+void testCellAccess() {
+    Ocean ocean(5, 3);
+    CHECK(ocean.getWidth() == 5 && ocean.getHeight() == 3);
+    for (int y = 0; y < 3; ++y) {
+        for (int x = 0; x < 5; ++x) {
+            CHECK(ocean.getCellType(x, y) == EntityType::Sand);
+        }
+    }
+    ocean.setCell(4, 2, EntityType::PredatorFish);
+    ocean.setCell(0, 0, EntityType::Algae);
+    CHECK(ocean.getCellType(4, 2) == EntityType::PredatorFish);
+    CHECK(ocean.getCellType(0, 0) == EntityType::Algae);
+    CHECK(ocean.getCellType(3, 2) == EntityType::Sand);
+    CHECK(ocean.getCellType(4, 1) == EntityType::Sand);
+
+    CHECK(ocean.inBounds(0, 0) && ocean.inBounds(4, 2));
+    CHECK(!ocean.inBounds(5, 0) && !ocean.inBounds(0, 3) && !ocean.inBounds(-1, 0));
+    CHECK_THROWS(ocean.getCellType(5, 0), std::out_of_range);
+    CHECK_THROWS(ocean.getCellType(0, -1), std::out_of_range);
+    CHECK_THROWS(ocean.setCell(0, 3, EntityType::Algae), std::out_of_range);
+    CHECK_THROWS(Ocean(0, 3), std::invalid_argument);
+    CHECK_THROWS(Ocean(3, -1), std::invalid_argument);
+}
+
+void testCopiesAreIndependent() {
+    Ocean original(4, 4);
+    original.setCell(1, 1, EntityType::Algae);
+    Ocean copy = original;
+    copy.setCell(1, 1, EntityType::Sand);
+    copy.setCell(2, 2, EntityType::HerbivoreFish);
+    CHECK(original.getCellType(1, 1) == EntityType::Algae);
+    CHECK(original.getCellType(2, 2) == EntityType::Sand);
+    CHECK(copy.getCellType(1, 1) == EntityType::Sand);
+
+    Ocean assigned(2, 2);
+    assigned = original;
+    CHECK(sameCells(assigned, original));
+}
+
+// Такт пишет в задний буфер и меняет буферы местами: правки между тактами
+// не теряются, а состояние двухтактной давности не возвращается.
+void testWritesBetweenTicks() {
+    Ocean ocean(6, 6, 1);
+    ocean.setCell(2, 2, EntityType::Algae);
+    ocean.tick();
+    for (int y = 0; y < 6; ++y) {
+        for (int x = 0; x < 6; ++x) {
+            ocean.setCell(x, y, EntityType::Sand);
+        }
+    }
+    ocean.tick();
+    ocean.tick();
+    bool empty = true;
+    for (int y = 0; y < 6; ++y) {
+        for (int x = 0; x < 6; ++x) {
+            empty = empty && ocean.getCellType(x, y) == EntityType::Sand;
+        }
+    }
+    CHECK(empty);
+
+    ocean.setCell(4, 4, EntityType::HerbivoreFish);
+    ocean.tick();
+    CHECK(ocean.countEntities(EntityType::HerbivoreFish) == 1);
+}
+
+void testCopyTicksLikeOriginal() {
+    Ocean original(40, 30, 9);
+    original.randomFill(120, 30, 10);
+    for (int t = 0; t < 5; ++t) {
+        original.tick();
+    }
+    Ocean copy = original;
+    for (int t = 0; t < 10; ++t) {
+        original.tick();
+        copy.tick();
+    }
+    CHECK(sameCells(original, copy));
+    CHECK(copy.getTickCount() == original.getTickCount());
+}
+
+
+// Возраст и голод хранятся по клеткам и переезжают вместе с существом.
+void testAgeAndHungerFollowCreature() {
+    Ocean ocean(2, 1);
+    ocean.setCell(0, 0, EntityType::HerbivoreFish, 3, 2);
+    CHECK(ocean.getAge(0, 0) == 3 && ocean.getHunger(0, 0) == 2);
+    CHECK(ocean.getAge(1, 0) == 0 && ocean.getHunger(1, 0) == 0);
+    ocean.tick();
+    // Единственная соседняя клетка — песок справа.
+    CHECK(ocean.getCellType(0, 0) == EntityType::Sand);
+    CHECK(ocean.getCellType(1, 0) == EntityType::HerbivoreFish);
+    CHECK(ocean.getAge(1, 0) == 4 && ocean.getHunger(1, 0) == 3);
+    CHECK(ocean.getAge(0, 0) == 0 && ocean.getHunger(0, 0) == 0);
+
+    Ocean lone(1, 1);
+    lone.setCell(0, 0, EntityType::Algae);
+    for (int t = 1; t <= 5; ++t) {
+        lone.tick();
+        CHECK(lone.getAge(0, 0) == t);
+    }
+}
+
+// Результат такта не зависит от числа потоков; поле больше плитки по обеим осям.
+void testThreadCountDoesNotMatter() {
+    Ocean reference(200, 150, 5);
+    reference.randomFill(6000, 1200, 400);
+    Ocean threaded = reference;
+    Ocean odd = reference;
+    threaded.setThreadCount(4);
+    odd.setThreadCount(3);
+    CHECK(threaded.getThreadCount() == 4);
+    for (int t = 0; t < 30; ++t) {
+        reference.tick();
+        threaded.tick();
+        odd.tick();
+    }
+    CHECK(sameCells(reference, threaded));
+    CHECK(sameCells(reference, odd));
+    CHECK(reference.countAllEntities() == threaded.countAllEntities());
+    CHECK_THROWS(threaded.setThreadCount(0), std::invalid_argument);
+}
+
+// Число потоков можно менять между тактами: журналы изменений убранных
+// потоков не теряются, и поле совпадает с однопоточным прогоном.
+void testThreadCountChangesBetweenTicks() {
+    for (int size : {100, 300}) {
+        Ocean reference(size, size, 8);
+        reference.randomFill(size * size / 10, size * size / 50, size * size / 150);
+        Ocean changed = reference;
+        changed.setThreadCount(4);
+        for (int t = 0; t < 8; ++t) {
+            if (t == 3) {
+                changed.setThreadCount(1);
+            }
+            if (t == 6) {
+                changed.setThreadCount(3);
+            }
+            reference.tick();
+            changed.tick();
+            CHECK(changed.countAllEntities() == scanCounts(changed));
+        }
+        CHECK(sameCells(reference, changed));
+        CHECK(reference.countAllEntities() == changed.countAllEntities());
+    }
+}
+
+// Счётчики видов ведутся при каждой записи и совпадают с полным подсчётом.
+void testCountsMatchScan() {
+    Ocean ocean(90, 70, 4);
+    ocean.setThreadCount(2);
+    ocean.randomFill(900, 200, 60);
+    CHECK(ocean.countAllEntities() == scanCounts(ocean));
+    CHECK(ocean.countEntities(EntityType::HerbivoreFish) == 200);
+    for (int t = 0; t < 25; ++t) {
+        ocean.tick();
+        CHECK(ocean.countAllEntities() == scanCounts(ocean));
+    }
+    ocean.setCell(0, 0, EntityType::PredatorFish);
+    ocean.setCell(0, 0, EntityType::PredatorFish);
+    ocean.setCell(1, 0, EntityType::Sand);
+    CHECK(ocean.countAllEntities() == scanCounts(ocean));
+    CHECK_THROWS(ocean.setCell(2, 0, static_cast<EntityType>(7)), std::invalid_argument);
+    CHECK(ocean.countAllEntities() == scanCounts(ocean));
+}
+
+// Такт обходит только плитки с существами: ни одно существо не должно
+// пропустить такт, даже переплыв в пустую плитку или оказавшись в ней после setCell.
+void testSparseTilesKeepEveryCreatureAlive() {
+    Ocean ocean(300, 200, 8);
+    const int spots[][2] = {{63, 63}, {64, 64}, {0, 0}, {127, 10}, {128, 199}, {299, 199}, {299, 0}, {191, 100}};
+    for (const auto& spot : spots) {
+        ocean.setCell(spot[0], spot[1], EntityType::HerbivoreFish);
+    }
+    // До возраста размножения никто не рождается и не умирает.
+    for (int t = 1; t < HerbivoreFish::REPRODUCE_AGE; ++t) {
+        ocean.tick();
+        int aged = 0;
+        for (int y = 0; y < 200; ++y) {
+            for (int x = 0; x < 300; ++x) {
+                aged += ocean.getCellType(x, y) == EntityType::HerbivoreFish && ocean.getAge(x, y) == t;
+            }
+        }
+        CHECK(aged == 8);
+    }
+
+    Ocean empty(300, 200);
+    empty.setCell(5, 5, EntityType::HerbivoreFish, 0, HerbivoreFish::MAX_HUNGER - 1);
+    for (int t = 0; t < 4; ++t) {
+        empty.tick();
+    }
+    CHECK(empty.countEntities(EntityType::HerbivoreFish) == 0);
+    empty.setCell(250, 150, EntityType::PredatorFish);
+    empty.tick();
+    CHECK(empty.countEntities(EntityType::PredatorFish) == 1);
+    bool moved = empty.getCellType(250, 150) == EntityType::Sand;
+    CHECK(moved);
+}
+}
+
+int main() {
+    testCellAccess();
+    testCopiesAreIndependent();
+    testWritesBetweenTicks();
+    testCopyTicksLikeOriginal();
+    testAgeAndHungerFollowCreature();
+    testThreadCountDoesNotMatter();
+    testThreadCountChangesBetweenTicks();
+    testCountsMatchScan();
+    testSparseTilesKeepEveryCreatureAlive();
+    return checkResult();
+}
\ No newline at end of file
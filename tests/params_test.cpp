@@ -0,0 +1,107 @@
+#include "Check.h"
+#include "Algae.h"
+#include "HerbivoreFish.h"
+#include "Ocean.h"
+#include "PredatorFish.h"
+#include "SpeciesParams.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const char* const PARAMS_PATH = "params_test.ini";
+
+void writeParams(const std::string& text) {
+    std::ofstream out(PARAMS_PATH, std::ios::trunc);
+    out << text;
+}
+
+// Константы классов и умолчания EcosystemParams — одни и те же числа.
+void testDefaults() {
+    EcosystemParams params;
+    CHECK(params.isDefault());
+    CHECK(params[EntityType::Algae].maxAge == Algae::MAX_AGE);
+    CHECK(params[EntityType::Algae].reproduceAge == Algae::REPRODUCE_AGE);
+    CHECK(params[EntityType::HerbivoreFish].maxHunger == HerbivoreFish::MAX_HUNGER);
+    CHECK(params[EntityType::HerbivoreFish].hungerDecrease == HerbivoreFish::HUNGER_DECREASE);
+    CHECK(params[EntityType::PredatorFish].maxAge == PredatorFish::MAX_AGE);
+    CHECK(params[EntityType::PredatorFish].reproduceAge == PredatorFish::REPRODUCE_AGE);
+    params.validate();
+    params[EntityType::PredatorFish].maxAge = 71;
+    CHECK(!params.isDefault());
+}
+
+void testLoadFile() {
+    writeParams("# sweep\n[herbivores]\nmax_age = 60 ; comment\nhunger_decrease=4\n\n[ predators ]\nmax_hunger = 20\n");
+    EcosystemParams params = loadEcosystemParams(PARAMS_PATH);
+    CHECK(params[EntityType::HerbivoreFish].maxAge == 60);
+    CHECK(params[EntityType::HerbivoreFish].hungerDecrease == 4);
+    CHECK(params[EntityType::HerbivoreFish].maxHunger == HerbivoreFish::MAX_HUNGER);
+    CHECK(params[EntityType::PredatorFish].maxHunger == 20);
+    CHECK(params[EntityType::Algae] == defaultSpeciesParams<EntityType::Algae>());
+}
+
+// Ошибка в файле сообщает номер строки; значения вне диапазона отвергаются.
+void testBadFiles() {
+    const char* const broken[] = {
+        "[herbivores]\nmax_age = 60\n[fungi]\n",
+        "[algae]\nmax_hunger\n",
+        "[algae]\nmax_age = 12x\n",
+        "max_age = 12\n",
+        "[algae]\nlifespan = 3\n",
+        "[predators\n",
+        "[predators]\nmax_hunger = 0\n",
+        "[algae]\nmax_age = 70000\n",
+    };
+    for (const char* text : broken) {
+        writeParams(text);
+        CHECK_THROWS(loadEcosystemParams(PARAMS_PATH), std::runtime_error);
+    }
+    writeParams("[algae]\nmax_age = 20\n[fungi]\n");
+    try {
+        loadEcosystemParams(PARAMS_PATH);
+    } catch (const std::runtime_error& e) {
+        CHECK(std::string(e.what()).find(std::string(PARAMS_PATH) + ":3:") == 0);
+    }
+    CHECK_THROWS(loadEcosystemParams("params_test_missing.ini"), std::runtime_error);
+
+    EcosystemParams params;
+    params[EntityType::HerbivoreFish].hungerDecrease = -1;
+    CHECK_THROWS(params.validate(), std::invalid_argument);
+    Ocean ocean(4, 4);
+    CHECK_THROWS(ocean.setSpeciesParams(params), std::invalid_argument);
+}
+
+// Параметры действуют со следующего такта: травоядное без еды, не успев
+// размножиться, исчезает от голода на такте maxHunger + 1.
+void testParamsChangeRules() {
+    for (int maxHunger : {3, HerbivoreFish::MAX_HUNGER}) {
+        EcosystemParams params;
+        params[EntityType::HerbivoreFish].maxHunger = maxHunger;
+        params[EntityType::HerbivoreFish].reproduceAge = 100;
+        Ocean ocean(5, 5, 1);
+        ocean.setSpeciesParams(params);
+        CHECK(ocean.getSpeciesParams() == params);
+        ocean.setCell(2, 2, EntityType::HerbivoreFish);
+        int alive = 0;
+        while (ocean.countAllEntities()[static_cast<std::size_t>(EntityType::HerbivoreFish)] > 0 && alive < 100) {
+            ocean.tick();
+            ++alive;
+        }
+        CHECK(alive == maxHunger + 1);
+    }
+}
+
+}
+
+int main() {
+    testDefaults();
+    testLoadFile();
+    testBadFiles();
+    testParamsChangeRules();
+    std::remove(PARAMS_PATH);
+    return checkResult();
+}
\ No newline at end of file
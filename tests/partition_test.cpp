@@ -0,0 +1,140 @@
+#include "Check.h"
+#include "OceanPartition.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Начальное поле задаётся функцией клетки, чтобы разделы и целое поле
+// заполнялись одинаково без общего генератора.
+EntityType startCell(int x, int y) {
+    std::uint32_t h = static_cast<std::uint32_t>(x) * 73856093u ^ static_cast<std::uint32_t>(y) * 19349663u;
+    h = (h ^ (h >> 13)) * 0x5bd1e995u;
+    h ^= h >> 15;
+    switch (h % 40) {
+        case 0: return EntityType::PredatorFish;
+        case 1: case 2: return EntityType::HerbivoreFish;
+        case 3: case 4: case 5: case 6: case 7: case 8: case 9: return EntityType::Algae;
+        default: return EntityType::Sand;
+    }
+}
+
+struct Case {
+    int width;
+    int height;
+    int ranks;
+    int threads;
+    int ticks;
+    bool customParams;
+};
+
+EcosystemParams customParams() {
+    EcosystemParams params;
+    params[EntityType::HerbivoreFish].maxAge = 30;
+    params[EntityType::PredatorFish].maxHunger = 7;
+    return params;
+}
+
+// Разделы в отдельных потоках на цепочке сокетов дают то же поле, что и
+// один Ocean, при любом числе разделов и потоков в каждом.
+void testMatchesWholeGrid() {
+    const Case cases[] = {
+        {70, 129, 3, 1, 120, false},
+        {50, 300, 4, 2, 120, false},
+        {64, 53, 5, 3, 100, true},
+        {40, 60, 1, 1, 60, false},
+    };
+    for (const Case& c : cases) {
+        const std::uint64_t seed = 42;
+        Ocean whole(c.width, c.height, seed);
+        if (c.customParams) {
+            whole.setSpeciesParams(customParams());
+        }
+        for (int y = 0; y < c.height; ++y) {
+            for (int x = 0; x < c.width; ++x) {
+                whole.setCell(x, y, startCell(x, y));
+            }
+        }
+
+        auto transports = SocketTransport::chain(c.ranks);
+        std::vector<std::unique_ptr<OceanPartition>> parts(static_cast<std::size_t>(c.ranks));
+        std::vector<EntityCounts> totals(static_cast<std::size_t>(c.ranks));
+        std::vector<std::thread> threads;
+        for (int rank = 0; rank < c.ranks; ++rank) {
+            threads.emplace_back([&, rank] {
+                auto part = std::make_unique<OceanPartition>(c.width, c.height, rank, c.ranks,
+                                                             *transports[static_cast<std::size_t>(rank)], seed);
+                part->setThreadCount(c.threads);
+                if (c.customParams) {
+                    part->setSpeciesParams(customParams());
+                }
+                for (int y = part->getFirstRow(); y < part->getRowEnd(); ++y) {
+                    for (int x = 0; x < c.width; ++x) {
+                        part->setCell(x, y, startCell(x, y));
+                    }
+                }
+                part->syncHalo();
+                for (int t = 0; t < c.ticks; ++t) {
+                    part->tick();
+                }
+                totals[static_cast<std::size_t>(rank)] = part->countAll();
+                parts[static_cast<std::size_t>(rank)] = std::move(part);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (int t = 0; t < c.ticks; ++t) {
+            whole.tick();
+        }
+
+        int next = 0;
+        for (const auto& part : parts) {
+            CHECK(part->getFirstRow() == next);
+            next = part->getRowEnd();
+            CHECK(part->getTickCount() == whole.getTickCount());
+            long long mismatches = 0;
+            int from = std::max(0, part->getFirstRow() - OceanPartition::HALO);
+            int to = std::min(c.height, part->getRowEnd() + OceanPartition::HALO);
+            for (int y = from; y < to; ++y) {
+                for (int x = 0; x < c.width; ++x) {
+                    mismatches += part->getCellType(x, y) != whole.getCellType(x, y) ||
+                                  part->getAge(x, y) != whole.getAge(x, y) ||
+                                  part->getHunger(x, y) != whole.getHunger(x, y);
+                }
+            }
+            CHECK(mismatches == 0);
+        }
+        CHECK(next == c.height);
+        for (const EntityCounts& total : totals) {
+            CHECK(total == whole.countAllEntities());
+        }
+    }
+}
+
+// Строки делятся поровну, у каждого раздела не меньше HALO строк.
+void testOwnedRows() {
+    CHECK(OceanPartition::ownedRows(100, 0, 1) == std::make_pair(0, 100));
+    int next = 0;
+    for (int rank = 0; rank < 7; ++rank) {
+        std::pair<int, int> rows = OceanPartition::ownedRows(100, rank, 7);
+        CHECK(rows.first == next);
+        CHECK(rows.second - rows.first >= 14 && rows.second - rows.first <= 15);
+        next = rows.second;
+    }
+    CHECK(next == 100);
+    CHECK_THROWS(OceanPartition::ownedRows(20, 0, 5), std::invalid_argument);
+}
+
+}
+
+int main() {
+    testMatchesWholeGrid();
+    testOwnedRows();
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "Check.h"
+#include "CounterRandom.h"
+#include "Ocean.h"
+
+#include <array>
+
+namespace {
+
+// Последовательность задаётся только парой (key, stream).
+void testCounterRandomStreams() {
+    std::uint64_t key = CounterRandom::key(42, 7);
+    CounterRandom a(key, 3), b(key, 3), other(key, 4), later(CounterRandom::key(42, 8), 3);
+    bool differs = false, differsByTick = false;
+    for (int i = 0; i < 16; ++i) {
+        std::uint64_t value = a();
+        CHECK(value == b());
+        differs = differs || value != other();
+        differsByTick = differsByTick || value != later();
+    }
+    CHECK(differs);
+    CHECK(differsByTick);
+}
+
+void testBelowIsInRange() {
+    CounterRandom gen(CounterRandom::key(1, 2), 3);
+    std::array<int, 7> hits{};
+    for (int i = 0; i < 7000; ++i) {
+        std::uint32_t value = gen.below(7);
+        CHECK(value < 7);
+        if (value < 7) ++hits[value];
+    }
+    for (int count : hits) {
+        CHECK(count > 800 && count < 1200);
+    }
+}
+
+// Одно зерно — один прогон, другое зерно — другой.
+void testOceanSeed() {
+    auto run = [](std::uint64_t seed) {
+        Ocean ocean(60, 40, seed);
+        ocean.randomFill(240, 48, 16);
+        for (int t = 0; t < 20; ++t) {
+            ocean.tick();
+        }
+        return ocean;
+    };
+    Ocean first = run(11), again = run(11), other = run(12);
+    CHECK(first.getSeed() == 11);
+    CHECK(sameCells(first, again));
+    CHECK(!sameCells(first, other));
+}
+
+}
+
+int main() {
+    testCounterRandomStreams();
+    testBelowIsInRange();
+    testOceanSeed();
+    return checkResult();
+}
\ No newline at end of file
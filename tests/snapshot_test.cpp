@@ -0,0 +1,162 @@
+#include "Check.h"
+#include "Ocean.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const SNAPSHOT_PATH = "snapshot_test.snap";
+const char* const DAMAGED_PATH = "snapshot_test_damaged.snap";
+
+// Смещения полей заголовка, см. SnapshotHeader в OceanSnapshot.cpp.
+constexpr std::size_t COUNTS_OFFSET = 56;
+constexpr std::size_t CELLS_OFFSET_OFFSET = 104;
+
+std::vector<char> readBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+template <class T>
+T field(const std::vector<char>& bytes, std::size_t offset) {
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+template <class T>
+void setField(std::vector<char>& bytes, std::size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// Продолжение со снимка совпадает с непрерывным прогоном.
+void testRoundTripContinues() {
+    for (Boundary boundary : {Boundary::Walls, Boundary::Torus}) {
+        Ocean ocean(150, 90, 9, boundary);
+        ocean.setThreadCount(3);
+        ocean.randomFill(3000, 600, 200);
+        for (int i = 0; i < 15; ++i) {
+            ocean.tick();
+        }
+        ocean.saveSnapshot(SNAPSHOT_PATH);
+        Ocean loaded = Ocean::loadSnapshot(SNAPSHOT_PATH);
+        CHECK(sameCells(loaded, ocean));
+        CHECK(loaded.getBoundary() == boundary);
+        CHECK(loaded.getTickCount() == ocean.getTickCount());
+        CHECK(loaded.countAllEntities() == ocean.countAllEntities());
+
+        loaded.setThreadCount(2);
+        for (int i = 0; i < 25; ++i) {
+            ocean.tick();
+            loaded.tick();
+        }
+        CHECK(sameCells(loaded, ocean));
+        CHECK(loaded.countAllEntities() == ocean.countAllEntities());
+    }
+}
+
+void testParamsSaved() {
+    EcosystemParams params;
+    params.species[static_cast<std::size_t>(EntityType::HerbivoreFish)].maxHunger = 7;
+    Ocean ocean(40, 30, 2);
+    ocean.setSpeciesParams(params);
+    ocean.randomFill(100, 50, 10);
+    ocean.saveSnapshot(SNAPSHOT_PATH);
+    CHECK(Ocean::loadSnapshot(SNAPSHOT_PATH).getSpeciesParams() == params);
+}
+
+// Испорченный снимок отвергается целиком, а не пишет за пределы массивов.
+// Заголовок и рамка проверяются всегда, клетки поля — только с verifyCells.
+void testDamagedRejected() {
+    Ocean ocean(40, 30, 4);
+    ocean.randomFill(300, 60, 20);
+    ocean.saveSnapshot(SNAPSHOT_PATH);
+    const std::vector<char> good = readBytes(SNAPSHOT_PATH);
+    const std::size_t cells = static_cast<std::size_t>(field<std::uint64_t>(good, CELLS_OFFSET_OFFSET));
+    const std::size_t stride = 40 + 2;
+    auto cell = [&](int x, int y) { return cells + static_cast<std::size_t>(y + 1) * stride + static_cast<std::size_t>(x + 1); };
+
+    std::vector<char> bytes = good;
+    bytes[cell(5, 7)] = 9;
+    writeBytes(DAMAGED_PATH, bytes);
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH, true), std::runtime_error);
+
+    bytes = good;
+    bytes[cell(-1, 12)] = static_cast<char>(EntityType::Sand);
+    writeBytes(DAMAGED_PATH, bytes);
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH), std::runtime_error);
+
+    bytes = good;
+    bytes[cell(40, 30)] = static_cast<char>(EntityType::Algae);
+    writeBytes(DAMAGED_PATH, bytes);
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH), std::runtime_error);
+
+    // Сумма счётчиков по-прежнему равна площади, но не совпадает с полем.
+    bytes = good;
+    std::size_t sand = COUNTS_OFFSET, algae = COUNTS_OFFSET + sizeof(std::int64_t);
+    setField(bytes, sand, field<std::int64_t>(bytes, sand) + 1);
+    setField(bytes, algae, field<std::int64_t>(bytes, algae) - 1);
+    writeBytes(DAMAGED_PATH, bytes);
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH, true), std::runtime_error);
+
+    // А такая сумма не сходится с площадью уже в заголовке.
+    setField(bytes, sand, field<std::int64_t>(bytes, sand) + 1);
+    writeBytes(DAMAGED_PATH, bytes);
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH), std::runtime_error);
+
+    bytes = good;
+    bytes.resize(bytes.size() / 2);
+    writeBytes(DAMAGED_PATH, bytes);
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH), std::runtime_error);
+
+    writeBytes(DAMAGED_PATH, std::vector<char>(200, 'x'));
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH), std::runtime_error);
+    CHECK_THROWS(Ocean::loadSnapshot("snapshot_test_missing.snap"), std::runtime_error);
+
+    // Нетронутый снимок по-прежнему загружается, в том числе с проверкой клеток.
+    writeBytes(DAMAGED_PATH, good);
+    CHECK(sameCells(Ocean::loadSnapshot(DAMAGED_PATH), ocean));
+    CHECK(sameCells(Ocean::loadSnapshot(DAMAGED_PATH, true), ocean));
+}
+
+// Существо вне списка активных плиток навсегда замерло бы, поэтому полная
+// проверка такой снимок отвергает.
+void testCreatureOutsideActiveTiles() {
+    Ocean ocean(200, 100, 6);
+    ocean.setCell(10, 10, EntityType::Algae);
+    ocean.saveSnapshot(SNAPSHOT_PATH);
+    std::vector<char> bytes = readBytes(SNAPSHOT_PATH);
+    const std::size_t cells = static_cast<std::size_t>(field<std::uint64_t>(bytes, CELLS_OFFSET_OFFSET));
+    const std::size_t far = cells + static_cast<std::size_t>(91) * (200 + 2) + 191;
+    bytes[far] = static_cast<char>(EntityType::Algae);
+    std::size_t sand = COUNTS_OFFSET, algae = COUNTS_OFFSET + sizeof(std::int64_t);
+    setField(bytes, sand, field<std::int64_t>(bytes, sand) - 1);
+    setField(bytes, algae, field<std::int64_t>(bytes, algae) + 1);
+    writeBytes(DAMAGED_PATH, bytes);
+    CHECK(Ocean::loadSnapshot(DAMAGED_PATH).countEntities(EntityType::Algae) == 2);
+    CHECK_THROWS(Ocean::loadSnapshot(DAMAGED_PATH, true), std::runtime_error);
+}
+
+}
+
+int main() {
+    testRoundTripContinues();
+    testParamsSaved();
+    testDamagedRejected();
+    testCreatureOutsideActiveTiles();
+    std::remove(SNAPSHOT_PATH);
+    std::remove(DAMAGED_PATH);
+    return checkResult();
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "Check.h"
+#include "Ocean.h"
+#include "TickStats.h"
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::size_t index(EntityType type) {
+    return static_cast<std::size_t>(type);
+}
+
+// Сведение потоков складывает счётчики, а CSV и JSON называют каждую метрику.
+void testMergeAndOutput() {
+    TickStats a;
+    a.ticks = 2;
+    a.updateSeconds = 0.5;
+    a.speciesSeconds[index(EntityType::HerbivoreFish)] = 0.25;
+    a.note(TickEvent::Eat, EntityType::HerbivoreFish);
+    TickStats b;
+    b.ticks = 3;
+    b.note(TickEvent::Eat, EntityType::HerbivoreFish);
+    b.note(TickEvent::Birth, EntityType::Algae);
+    a.merge(b);
+    CHECK(a.ticks == 5);
+    CHECK(a.count(TickEvent::Eat, EntityType::HerbivoreFish) == 2);
+    CHECK(a.count(TickEvent::Birth, EntityType::Algae) == 1);
+    CHECK(a.count(TickEvent::Move, EntityType::PredatorFish) == 0);
+
+    std::ostringstream csv;
+    a.writeCsv(csv);
+    CHECK(csv.str().rfind("metric,value\nticks,5\n", 0) == 0);
+    CHECK(csv.str().find("time.herbivores_seconds,0.25\n") != std::string::npos);
+    CHECK(csv.str().find("eats.herbivores,2\n") != std::string::npos);
+    CHECK(csv.str().find("births.algae,1\n") != std::string::npos);
+
+    std::ostringstream json;
+    a.writeJson(json);
+    CHECK(json.str().find("\"ticks\": 5,") != std::string::npos);
+    CHECK(json.str().find("\"herbivores_seconds\": 0.25") != std::string::npos);
+    CHECK(json.str().find("\"eats\": {\"algae\": 0, \"herbivores\": 2, \"predators\": 0}") != std::string::npos);
+}
+
+// События сходятся с изменением численности: вид теряет особей от старости,
+// голода, в драках и от чужих поеданий и получает рождениями. Без OCEAN_STATS —
+// одни нули.
+void testEventsMatchPopulation() {
+    Ocean ocean(120, 90, 3);
+    ocean.setThreadCount(3);
+    ocean.randomFill(2500, 700, 150);
+    EntityCounts before = ocean.countAllEntities();
+    for (int i = 0; i < 40; ++i) {
+        ocean.tick();
+    }
+    EntityCounts after = ocean.countAllEntities();
+    const TickStats& stats = ocean.getStats();
+    if constexpr (!STATS_ENABLED) {
+        CHECK(stats.ticks == 0 && stats.updateSeconds == 0);
+        CHECK(stats.count(TickEvent::Move, EntityType::HerbivoreFish) == 0);
+        return;
+    }
+    CHECK(stats.ticks == 40);
+    const EntityType eaterOf[4] = {EntityType::Sand, EntityType::HerbivoreFish, EntityType::PredatorFish,
+                                   EntityType::Sand};
+    for (EntityType species : {EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+        EntityType eater = eaterOf[index(species)];
+        long long eaten = eater == EntityType::Sand ? 0 : stats.count(TickEvent::Eat, eater);
+        long long change = stats.count(TickEvent::Birth, species) - stats.count(TickEvent::DeathByAge, species) -
+                           stats.count(TickEvent::DeathByHunger, species) -
+                           stats.count(TickEvent::DeathInFight, species) - eaten;
+        CHECK(after[index(species)] - before[index(species)] == change);
+        CHECK(stats.speciesSeconds[index(species)] > 0);
+    }
+    CHECK(stats.count(TickEvent::Move, EntityType::HerbivoreFish) > 0);
+
+    ocean.resetStats();
+    CHECK(ocean.getStats().ticks == 0);
+    CHECK(ocean.getStats().count(TickEvent::Birth, EntityType::Algae) == 0);
+}
+
+}
+
+int main() {
+    testMergeAndOutput();
+    testEventsMatchPopulation();
+    return checkResult();
+}
\ No newline at end of file
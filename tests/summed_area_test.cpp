@@ -0,0 +1,138 @@
+#include "Check.h"
+#include "Ocean.h"
+#include "SummedAreaTable.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+long long naiveCount(const Ocean& ocean, EntityType type, int x, int y, int width, int height) {
+    long long count = 0;
+    for (int j = std::max(0, y); j < std::min(ocean.getHeight(), y + height); ++j) {
+        for (int i = std::max(0, x); i < std::min(ocean.getWidth(), x + width); ++i) {
+            count += ocean.getCellType(i, j) == type;
+        }
+    }
+    return count;
+}
+
+// Псевдослучайные прямоугольники, в том числе выходящие за край поля.
+struct Rect {
+    int x, y, width, height;
+};
+
+std::vector<Rect> rects(int count, std::uint32_t seed) {
+    std::vector<Rect> out;
+    for (int i = 0; i < count; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        int x = static_cast<int>(seed >> 8) % 340 - 20;
+        seed = seed * 1664525u + 1013904223u;
+        int y = static_cast<int>(seed >> 8) % 260 - 20;
+        seed = seed * 1664525u + 1013904223u;
+        out.push_back({x, y, static_cast<int>(seed >> 8) % 200, static_cast<int>(seed >> 20) % 200});
+    }
+    return out;
+}
+
+// С отслеживанием и без него ответы совпадают с прямым подсчётом, в том
+// числе после правок поля между тактами.
+void testCountsMatchScan() {
+    for (bool tracking : {false, true}) {
+        Ocean ocean(300, 217, 4);
+        ocean.setThreadCount(tracking ? 3 : 1);
+        ocean.setSummedAreaTracking(tracking);
+        CHECK(ocean.getSummedAreaTracking() == tracking);
+        ocean.randomFill(9000, 2000, 600);
+        for (int t = 0; t < 6; ++t) {
+            ocean.tick();
+            if (t == 3) {
+                ocean.setCell(5, 5, EntityType::PredatorFish);
+            }
+            for (const Rect& r : rects(40, static_cast<std::uint32_t>(t))) {
+                for (EntityType type : {EntityType::Sand, EntityType::Algae, EntityType::HerbivoreFish,
+                                        EntityType::PredatorFish}) {
+                    CHECK(ocean.countInRect(type, r.x, r.y, r.width, r.height) ==
+                          naiveCount(ocean, type, r.x, r.y, r.width, r.height));
+                }
+            }
+            CHECK(ocean.countInRect(EntityType::Algae, 0, 0, 1 << 30, 1 << 30) ==
+                  ocean.countEntities(EntityType::Algae));
+        }
+        ocean.setSummedAreaTracking(false);
+        CHECK(ocean.countInRect(EntityType::HerbivoreFish, 10, 10, 50, 50) ==
+              naiveCount(ocean, EntityType::HerbivoreFish, 10, 10, 50, 50));
+    }
+}
+
+// Тепловая карта из таблицы и прямым проходом одинакова; неполные блоки у края учтены.
+void testHeatmap() {
+    Ocean ocean(100, 70, 8);
+    ocean.randomFill(2000, 400, 100);
+    ocean.tick();
+    Heatmap scanned;
+    ocean.buildHeatmap(16, scanned);
+    ocean.setSummedAreaTracking(true);
+    ocean.tick();
+    Heatmap tracked;
+    ocean.buildHeatmap(16, tracked);
+    CHECK(tracked.blocksX == 7 && tracked.blocksY == 5);
+    for (EntityType type : {EntityType::Sand, EntityType::Algae, EntityType::HerbivoreFish, EntityType::PredatorFish}) {
+        for (int by = 0; by < tracked.blocksY; ++by) {
+            for (int bx = 0; bx < tracked.blocksX; ++bx) {
+                CHECK(tracked.at(type, bx, by) == naiveCount(ocean, type, bx * 16, by * 16, 16, 16));
+            }
+        }
+    }
+    ocean.setSummedAreaTracking(false);
+    Heatmap again;
+    ocean.buildHeatmap(16, again);
+    CHECK(again.counts == tracked.counts);
+    CHECK(scanned.blocksX == tracked.blocksX);
+}
+
+// Константные запросы из нескольких потоков сразу после изменения поля:
+// таблицу перестраивает один из них, остальные получают те же ответы.
+void testConcurrentQueries() {
+    Ocean ocean(257, 190, 11);
+    ocean.randomFill(8000, 1500, 300);
+    const std::vector<Rect> queries = rects(200, 99);
+    for (int round = 0; round < 4; ++round) {
+        ocean.tick();
+        ocean.setCell(round, round, EntityType::Algae);
+        std::vector<long long> expected;
+        for (const Rect& r : queries) {
+            expected.push_back(naiveCount(ocean, EntityType::Algae, r.x, r.y, r.width, r.height));
+        }
+        std::vector<int> mismatches(4, 0);
+        std::vector<std::thread> threads;
+        const Ocean& shared = ocean;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (std::size_t k = 0; k < queries.size(); ++k) {
+                    std::size_t i = (k + static_cast<std::size_t>(t) * 50) % queries.size();
+                    const Rect& r = queries[i];
+                    mismatches[static_cast<std::size_t>(t)] +=
+                        shared.countInRect(EntityType::Algae, r.x, r.y, r.width, r.height) != expected[i];
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (int count : mismatches) {
+            CHECK(count == 0);
+        }
+    }
+}
+
+}
+
+int main() {
+    testCountsMatchScan();
+    testHeatmap();
+    testConcurrentQueries();
+    return checkResult();
+}
\ No newline at end of file
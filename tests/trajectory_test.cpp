@@ -0,0 +1,123 @@
+#include "Check.h"
+#include "Ocean.h"
+#include "Trajectory.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const TRAJECTORY_PATH = "trajectory_test.traj";
+
+std::string readText(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Неверные аргументы отвергаются до открытия файла и не стирают его.
+void testBadArgumentsKeepFile() {
+    {
+        std::ofstream out(TRAJECTORY_PATH, std::ios::binary | std::ios::trunc);
+        out << "earlier recording";
+    }
+    CHECK_THROWS(TrajectoryRecorder(TRAJECTORY_PATH, 0), std::invalid_argument);
+    CHECK_THROWS(TrajectoryRecorder(TRAJECTORY_PATH, 10, 0), std::invalid_argument);
+    CHECK(readText(TRAJECTORY_PATH) == "earlier recording");
+}
+
+// Записывает начальное состояние и ticks тактов, возвращает записанные кадры.
+std::vector<OceanFrame> recordRun(int ticks, int keyframeInterval) {
+    Ocean ocean(90, 70, 12);
+    ocean.randomFill(1500, 300, 80);
+    std::vector<OceanFrame> frames;
+    TrajectoryRecorder recorder(TRAJECTORY_PATH, keyframeInterval, 2);
+    for (int i = 0; i <= ticks; ++i) {
+        if (i > 0) {
+            ocean.tick();
+        }
+        recorder.record(ocean);
+        frames.emplace_back();
+        ocean.captureFrame(frames.back());
+    }
+    recorder.close();
+    CHECK(recorder.getFramesRecorded() == ticks + 1);
+    return frames;
+}
+
+bool sameFrame(const OceanFrame& a, const OceanFrame& b) {
+    return a.width == b.width && a.height == b.height && a.tick == b.tick && a.counts == b.counts &&
+           a.cells == b.cells;
+}
+
+// Подряд читаются ровно записанные кадры, ключевые и дельты.
+void testReadBack() {
+    std::vector<OceanFrame> frames = recordRun(30, 7);
+    TrajectoryReader reader(TRAJECTORY_PATH);
+    CHECK(reader.getWidth() == 90 && reader.getHeight() == 70);
+    CHECK(reader.getKeyframeInterval() == 7);
+    CHECK(reader.getFirstTick() == 0);
+    for (const OceanFrame& frame : frames) {
+        CHECK(reader.next());
+        CHECK(sameFrame(reader.frame(), frame));
+    }
+    CHECK(!reader.next());
+}
+
+// Перемотка вперёд, назад и за последний кадр.
+void testSeek() {
+    std::vector<OceanFrame> frames = recordRun(30, 7);
+    TrajectoryReader reader(TRAJECTORY_PATH);
+    for (long long tick : {17LL, 20LL, 3LL, 14LL, 14LL, 30LL, 0LL}) {
+        reader.seek(tick);
+        CHECK(sameFrame(reader.frame(), frames[static_cast<std::size_t>(tick)]));
+    }
+    reader.seek(1000);
+    CHECK(sameFrame(reader.frame(), frames.back()));
+    CHECK(!reader.next());
+    reader.seek(9);
+    CHECK(reader.next());
+    CHECK(sameFrame(reader.frame(), frames[10]));
+    CHECK_THROWS(reader.seek(-1), std::out_of_range);
+}
+
+// Оборванная запись без индекса читается до последнего целого кадра.
+void testTruncatedFile() {
+    std::vector<OceanFrame> frames = recordRun(30, 7);
+    std::string bytes = readText(TRAJECTORY_PATH);
+    {
+        std::ofstream out(TRAJECTORY_PATH, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() * 2 / 3));
+    }
+    TrajectoryReader reader(TRAJECTORY_PATH);
+    std::size_t read = 0;
+    while (reader.next()) {
+        CHECK(read < frames.size() && sameFrame(reader.frame(), frames[read]));
+        ++read;
+    }
+    CHECK(read > 0 && read < frames.size());
+    reader.seek(static_cast<long long>(read) - 1);
+    CHECK(sameFrame(reader.frame(), frames[read - 1]));
+    reader.seek(30);
+    CHECK(sameFrame(reader.frame(), frames[read - 1]));
+
+    {
+        std::ofstream out(TRAJECTORY_PATH, std::ios::binary | std::ios::trunc);
+        out << "not a trajectory";
+    }
+    CHECK_THROWS(TrajectoryReader(TRAJECTORY_PATH), std::runtime_error);
+}
+
+}
+
+int main() {
+    testBadArgumentsKeepFile();
+    testReadBack();
+    testSeek();
+    testTruncatedFile();
+    std::remove(TRAJECTORY_PATH);
+    return checkResult();
+}
\ No newline at end of file